@@ -205,10 +205,10 @@ void cmCTestBuildHandler::Initialize()
   this->ReallyCustomWarningExceptions.clear();
   this->ErrorWarningFileLineRegex.clear();
 
-  this->ErrorMatchRegex.clear();
-  this->ErrorExceptionRegex.clear();
-  this->WarningMatchRegex.clear();
-  this->WarningExceptionRegex.clear();
+  this->LogRegexes.Clear();
+  this->ErrorMatchEnd = 0;
+  this->ErrorExceptionEnd = 0;
+  this->WarningMatchEnd = 0;
   this->BuildProcessingQueue.clear();
   this->BuildProcessingErrorQueue.clear();
   this->BuildOutputLogSize = 0;
@@ -329,6 +329,7 @@ int cmCTestBuildHandler::ProcessHandler()
     ++ entry )
     {
     cmCTestBuildHandler::cmCTestCompileErrorWarningRex r;
+    r.RegularExpression.set_engine(cmsys::RegularExpression::Linear);
     if ( r.RegularExpression.compile(
         cmCTestWarningErrorFileLine[entry].RegularExpressionString) )
       {
@@ -399,27 +400,27 @@ int cmCTestBuildHandler::ProcessHandler()
     this->CustomWarningExceptions.push_back(cmCTestWarningExceptions[cc]);
     }
 
-  // Pre-compile regular expressions objects for all regular expressions
+  // Pre-compile regular expressions objects for all regular expressions.
+  // They go into one set so that each line is scanned once for all of them.
   std::vector<std::string>::iterator it;
 
-#define cmCTestBuildHandlerPopulateRegexVector(strings, regexes) \
-  regexes.clear(); \
-    cmCTestLog(this->CTest, DEBUG, this << "Add " #regexes \
+#define cmCTestBuildHandlerPopulateRegexVector(strings) \
+  cmCTestLog(this->CTest, DEBUG, this << "Add " #strings \
     << std::endl); \
   for ( it = strings.begin(); it != strings.end(); ++it ) \
     { \
     cmCTestLog(this->CTest, DEBUG, "Add " #strings ": " \
     << *it << std::endl); \
-    regexes.push_back(it->c_str()); \
+    this->LogRegexes.Add(it->c_str()); \
     }
-  cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomErrorMatches, this->ErrorMatchRegex);
-  cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomErrorExceptions, this->ErrorExceptionRegex);
-  cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomWarningMatches, this->WarningMatchRegex);
-  cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomWarningExceptions, this->WarningExceptionRegex);
+  this->LogRegexes.Clear();
+  cmCTestBuildHandlerPopulateRegexVector(this->CustomErrorMatches);
+  this->ErrorMatchEnd = this->LogRegexes.GetSize();
+  cmCTestBuildHandlerPopulateRegexVector(this->CustomErrorExceptions);
+  this->ErrorExceptionEnd = this->LogRegexes.GetSize();
+  cmCTestBuildHandlerPopulateRegexVector(this->CustomWarningMatches);
+  this->WarningMatchEnd = this->LogRegexes.GetSize();
+  cmCTestBuildHandlerPopulateRegexVector(this->CustomWarningExceptions);
 
 
   // Determine source and binary tree substitutions to simplify the output.
@@ -1224,83 +1225,63 @@ int cmCTestBuildHandler::ProcessSingleLine(const char* data)
 
   cmCTestLog(this->CTest, DEBUG, "Line: [" << data << "]" << std::endl);
 
-  std::vector<cmsys::RegularExpression>::iterator it;
-
   int warningLine = 0;
   int errorLine = 0;
 
-  // Check for regular expressions
+  // Check for regular expressions.  Exceptions only matter for lines
+  // that matched, and warnings only for lines that are not errors.
+  this->LogRegexes.Scan(data);
+  int match;
 
   if ( !this->ErrorQuotaReached )
     {
     // Errors
-    int wrxCnt = 0;
-    for ( it = this->ErrorMatchRegex.begin();
-      it != this->ErrorMatchRegex.end();
-      ++ it )
+    match = this->LogRegexes.Find(0, this->ErrorMatchEnd);
+    if ( match >= 0 )
       {
-      if ( it->find(data) )
-        {
-        errorLine = 1;
-        cmCTestLog(this->CTest, DEBUG, "  Error Line: " << data
-          << " (matches: " << this->CustomErrorMatches[wrxCnt] << ")"
-          << std::endl);
-        break;
-        }
-      wrxCnt ++;
-      }
-    // Error exceptions
-    wrxCnt = 0;
-    for ( it = this->ErrorExceptionRegex.begin();
-      it != this->ErrorExceptionRegex.end();
-      ++ it )
-      {
-      if ( it->find(data) )
+      errorLine = 1;
+      cmCTestLog(this->CTest, DEBUG, "  Error Line: " << data
+        << " (matches: " << this->CustomErrorMatches[match] << ")"
+        << std::endl);
+
+      // Error exceptions
+      match = this->LogRegexes.Find(this->ErrorMatchEnd,
+                                    this->ErrorExceptionEnd);
+      if ( match >= 0 )
         {
         errorLine = 0;
         cmCTestLog(this->CTest, DEBUG, "  Not an error Line: " << data
-          << " (matches: " << this->CustomErrorExceptions[wrxCnt] << ")"
-          << std::endl);
-        break;
+          << " (matches: "
+          << this->CustomErrorExceptions[match - this->ErrorMatchEnd]
+          << ")" << std::endl);
         }
-      wrxCnt ++;
       }
     }
-  if ( !this->WarningQuotaReached )
+  if ( !this->WarningQuotaReached && !errorLine )
     {
     // Warnings
-    int wrxCnt = 0;
-    for ( it = this->WarningMatchRegex.begin();
-      it != this->WarningMatchRegex.end();
-      ++ it )
+    match = this->LogRegexes.Find(this->ErrorExceptionEnd,
+                                  this->WarningMatchEnd);
+    if ( match >= 0 )
       {
-      if ( it->find(data) )
-        {
-        warningLine = 1;
-        cmCTestLog(this->CTest, DEBUG,
-          "  Warning Line: " << data
-          << " (matches: " << this->CustomWarningMatches[wrxCnt] << ")"
-          << std::endl);
-        break;
-        }
-      wrxCnt ++;
-      }
-
-    wrxCnt = 0;
-    // Warning exceptions
-    for ( it = this->WarningExceptionRegex.begin();
-      it != this->WarningExceptionRegex.end();
-      ++ it )
-      {
-      if ( it->find(data) )
+      warningLine = 1;
+      cmCTestLog(this->CTest, DEBUG,
+        "  Warning Line: " << data
+        << " (matches: "
+        << this->CustomWarningMatches[match - this->ErrorExceptionEnd]
+        << ")" << std::endl);
+
+      // Warning exceptions
+      match = this->LogRegexes.Find(this->WarningMatchEnd,
+                                    this->LogRegexes.GetSize());
+      if ( match >= 0 )
         {
         warningLine = 0;
         cmCTestLog(this->CTest, DEBUG, "  Not a warning Line: " << data
-          << " (matches: " << this->CustomWarningExceptions[wrxCnt] << ")"
-          << std::endl);
-        break;
+          << " (matches: "
+          << this->CustomWarningExceptions[match - this->WarningMatchEnd]
+          << ")" << std::endl);
         }
-      wrxCnt ++;
       }
     }
   if ( errorLine )
@@ -15,6 +15,7 @@
 
 
 #include "cmCTestGenericHandler.h"
+#include "cmCTestRegexSet.h"
 #include "cmListFileCache.h"
 
 #include <cmsys/RegularExpression.hxx>
@@ -105,10 +106,12 @@ private:
   std::vector<std::string> ReallyCustomWarningExceptions;
   std::vector<cmCTestCompileErrorWarningRex> ErrorWarningFileLineRegex;
 
-  std::vector<cmsys::RegularExpression> ErrorMatchRegex;
-  std::vector<cmsys::RegularExpression> ErrorExceptionRegex;
-  std::vector<cmsys::RegularExpression> WarningMatchRegex;
-  std::vector<cmsys::RegularExpression> WarningExceptionRegex;
+  // Expressions classifying output lines, in four consecutive ranges:
+  // error matches, error exceptions, warning matches, warning exceptions.
+  cmCTestRegexSet LogRegexes;
+  int ErrorMatchEnd;
+  int ErrorExceptionEnd;
+  int WarningMatchEnd;
 
   typedef std::deque<char> t_BuildProcessingQueueType;
 
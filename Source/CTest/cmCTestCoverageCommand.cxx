@@ -18,6 +18,9 @@
 cmCTestCoverageCommand::cmCTestCoverageCommand()
 {
   this->LabelsMentioned = false;
+  this->Arguments[ctc_PARALLEL_LEVEL] = "PARALLEL_LEVEL";
+  this->Arguments[ctc_LAST] = 0;
+  this->Last = ctc_LAST;
 }
 
 //----------------------------------------------------------------------------
@@ -35,6 +38,11 @@ cmCTestGenericHandler* cmCTestCoverageCommand::InitializeHandler()
     return 0;
     }
 
+  if(this->Values[ctc_PARALLEL_LEVEL])
+    {
+    handler->SetOption("ParallelLevel", this->Values[ctc_PARALLEL_LEVEL]);
+    }
+
   // If a LABELS option was given, select only files with the labels.
   if(this->LabelsMentioned)
     {
@@ -49,6 +49,11 @@ protected:
   virtual bool CheckArgumentKeyword(std::string const& arg);
   virtual bool CheckArgumentValue(std::string const& arg);
 
+  enum {
+    ctc_PARALLEL_LEVEL = ct_LAST,
+    ctc_LAST
+  };
+
   enum
   {
     ArgumentDoingLabels = Superclass::ArgumentDoingLast1,
@@ -130,6 +130,20 @@ private:
   double TimeOut;
 };
 
+//----------------------------------------------------------------------
+// One gcov process run by HandleGCovCoverage.  Each slot of the pool has
+// its own directory because gcov writes its .gcov files to the current
+// directory and different object files often produce the same names.
+struct cmCTestGCovRun
+{
+  std::string Dir;
+  std::string File;
+  std::string Command;
+  std::string Output;
+  std::string Errors;
+  cmsysProcess* Process;
+};
+
 
 //----------------------------------------------------------------------
 
@@ -557,7 +571,7 @@ int cmCTestCoverageHandler::ProcessHandler()
         }
       covLogFile << "\t\t<Line Number=\"" << cc << "\" Count=\"" << fcov[cc]
         << "\">"
-        << cmXMLSafe(line) << "</Line>" << std::endl;
+        << cmXMLSafe(line) << "</Line>\n";
       if ( fcov[cc] == 0 )
         {
         untested ++;
@@ -631,7 +645,7 @@ int cmCTestCoverageHandler::ProcessHandler()
     while (cmSystemTools::GetLineFromStream(ifs, line))
       {
       covLogFile << "\t\t<Line Number=\"" << untested << "\" Count=\"0\">"
-        << cmXMLSafe(line) << "</Line>" << std::endl;
+        << cmXMLSafe(line) << "</Line>\n";
       untested ++;
       }
     covLogFile << "\t\t</Report>\n\t</File>" << std::endl;
@@ -970,11 +984,37 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
     return 0;
     }
 
+  // Run up to this many gcov processes at once.
+  int parallelLevel = this->CTest->GetParallelLevel();
+  if(const char* pl = this->GetOption("ParallelLevel"))
+    {
+    parallelLevel = atoi(pl);
+    }
+  if(parallelLevel < 1)
+    {
+    parallelLevel = 1;
+    }
+  if(static_cast<size_t>(parallelLevel) > files.size())
+    {
+    parallelLevel = static_cast<int>(files.size());
+    }
+
   std::string testingDir = this->CTest->GetBinaryDir() + "/Testing";
   std::string tempDir = testingDir + "/CoverageInfo";
-  std::string currentDirectory = cmSystemTools::GetCurrentWorkingDirectory();
   cmSystemTools::MakeDirectory(tempDir.c_str());
-  cmSystemTools::ChangeDirectory(tempDir.c_str());
+  std::vector<cmCTestGCovRun> runs(parallelLevel);
+  for(int slot = 0; slot < parallelLevel; ++slot)
+    {
+    runs[slot].Dir = tempDir;
+    if(parallelLevel > 1)
+      {
+      cmOStringStream dir;
+      dir << tempDir << "/" << slot;
+      runs[slot].Dir = dir.str();
+      cmSystemTools::MakeDirectory(runs[slot].Dir.c_str());
+      }
+    runs[slot].Process = 0;
+    }
 
   int gcovStyle = 0;
 
@@ -994,35 +1034,134 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
   // These are binary files that you give as input to gcov so that it will
   // give us text output we can analyze to summarize coverage.
   //
-  for ( it = files.begin(); it != files.end(); ++ it )
+  // Start gcov on as many files as there are free slots, then wait for
+  // any one of them to finish and merge its results before reusing its
+  // slot.
+  //
+  it = files.begin();
+  int active = 0;
+  while ( it != files.end() || active > 0 )
     {
-    cmCTestLog(this->CTest, HANDLER_OUTPUT, "." << std::flush);
+    for(int slot = 0; slot < parallelLevel && it != files.end(); ++slot)
+      {
+      cmCTestGCovRun& run = runs[slot];
+      if(run.Process)
+        {
+        continue;
+        }
 
-    // Call gcov to get coverage data for this *.gcda file:
-    //
-    std::string fileDir = cmSystemTools::GetFilenamePath(*it);
-    std::string command = "\"" + gcovCommand + "\" " +
-      gcovExtraFlags + " " +
-      "-o \"" + fileDir + "\" " +
-      "\"" + *it + "\"";
+      // Call gcov to get coverage data for this *.gcda file:
+      //
+      std::string fileDir = cmSystemTools::GetFilenamePath(*it);
+      run.File = *it++;
+      run.Command = "\"" + gcovCommand + "\" " +
+        gcovExtraFlags + " " +
+        "-o \"" + fileDir + "\" " +
+        "\"" + run.File + "\"";
+      run.Output = "";
+      run.Errors = "";
+
+      cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, run.Command.c_str()
+        << std::endl);
 
-    cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, command.c_str()
-      << std::endl);
+      std::vector<std::string> args =
+        cmSystemTools::ParseArguments(run.Command.c_str());
+      std::vector<const char*> argv;
+      for(std::vector<std::string>::const_iterator a = args.begin();
+          a != args.end(); ++a)
+        {
+        argv.push_back(a->c_str());
+        }
+      argv.push_back(0);
+      run.Process = cmsysProcess_New();
+      cmsysProcess_SetCommand(run.Process, &*argv.begin());
+      cmsysProcess_SetWorkingDirectory(run.Process, run.Dir.c_str());
+      cmsysProcess_SetOption(run.Process,
+                             cmsysProcess_Option_HideWindow, 1);
+      cmsysProcess_Execute(run.Process);
+      ++active;
+      }
 
-    std::string output = "";
-    std::string errors = "";
+    // Wait for output from any running process and collect it until
+    // one of them finishes.  Free slots hold no process and are ignored.
+    std::vector<cmsysProcess*> processes;
+    for(int slot = 0; slot < parallelLevel; ++slot)
+      {
+      processes.push_back(runs[slot].Process);
+      }
+    int done = -1;
+    while(done < 0)
+      {
+      int slot = cmsysProcess_WaitForAny(&*processes.begin(),
+                                         parallelLevel, 0);
+      if(slot < 0)
+        {
+        continue;
+        }
+      cmCTestGCovRun& run = runs[slot];
+      int pipe;
+      do
+        {
+        char* data;
+        int length;
+        double timeout = 0;
+        pipe = cmsysProcess_WaitForData(run.Process, &data, &length,
+                                        &timeout);
+        if(pipe == cmsysProcess_Pipe_STDOUT)
+          {
+          run.Output.append(data, length);
+          }
+        else if(pipe == cmsysProcess_Pipe_STDERR)
+          {
+          run.Errors.append(data, length);
+          }
+        else if(pipe == cmsysProcess_Pipe_None)
+          {
+          done = slot;
+          }
+        }
+      while(pipe == cmsysProcess_Pipe_STDOUT ||
+            pipe == cmsysProcess_Pipe_STDERR);
+      }
+
+    cmCTestGCovRun& run = runs[done];
+    cmsysProcess_WaitForExit(run.Process, 0);
+    bool res = true;
     int retVal = 0;
-    *cont->OFS << "* Run coverage for: " << fileDir << std::endl;
-    *cont->OFS << "  Command: " << command << std::endl;
-    int res = this->CTest->RunCommand(command.c_str(), &output, &errors,
-      &retVal, tempDir.c_str(), 0 /*this->TimeOut*/);
+    switch(cmsysProcess_GetState(run.Process))
+      {
+      case cmsysProcess_State_Exited:
+        retVal = cmsysProcess_GetExitValue(run.Process);
+        break;
+      case cmsysProcess_State_Exception:
+        run.Errors += cmsysProcess_GetExceptionString(run.Process);
+        res = false;
+        break;
+      case cmsysProcess_State_Error:
+        run.Errors += cmsysProcess_GetErrorString(run.Process);
+        res = false;
+        break;
+      default:
+        res = false;
+        break;
+      }
+    cmsysProcess_Delete(run.Process);
+    run.Process = 0;
+    --active;
 
+    cmCTestLog(this->CTest, HANDLER_OUTPUT, "." << std::flush);
+
+    std::string const& output = run.Output;
+    std::string const& errors = run.Errors;
+    *cont->OFS << "* Run coverage for: "
+      << cmSystemTools::GetFilenamePath(run.File) << std::endl;
+    *cont->OFS << "  Command: " << run.Command << std::endl;
     *cont->OFS << "  Output: " << output << std::endl;
     *cont->OFS << "  Errors: " << errors << std::endl;
     if ( ! res )
       {
       cmCTestLog(this->CTest, ERROR_MESSAGE,
-        "Problem running coverage on file: " << *it << std::endl);
+        "Problem running coverage on file: " << run.File << std::endl);
       cmCTestLog(this->CTest, ERROR_MESSAGE,
         "Command produced error: " << errors << std::endl);
       cont->Error ++;
@@ -1031,7 +1170,7 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
     if ( retVal != 0 )
       {
       cmCTestLog(this->CTest, ERROR_MESSAGE, "Coverage command returned: "
-        << retVal << " while processing: " << *it << std::endl);
+        << retVal << " while processing: " << run.File << std::endl);
       cmCTestLog(this->CTest, ERROR_MESSAGE,
         "Command produced error: " << cont->Error << std::endl);
       }
@@ -1218,7 +1357,10 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
         cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, "   in gcovFile: "
           << gcovFile << std::endl);
 
-        cmsys::ifstream ifile(gcovFile.c_str());
+        // gcov names the file relative to the directory it ran in.
+        std::string gcovPath =
+          cmSystemTools::CollapseFullPath(gcovFile.c_str(), run.Dir.c_str());
+        cmsys::ifstream ifile(gcovPath.c_str());
         if ( ! ifile )
           {
           cmCTestLog(this->CTest, ERROR_MESSAGE, "Cannot open file: "
@@ -1248,26 +1390,24 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
 
             // Read the coverage count from the beginning of the gcov output
             // line
-            std::string prefix = nl.substr(0, 12);
-            int cov = atoi(prefix.c_str());
+            const char* prefix = nl.c_str();
+            int cov = atoi(prefix);
 
             // Read the line number starting at the 10th character of the gcov
             // output line
-            std::string lineNumber = nl.substr(10, 5);
-
-            int lineIdx = atoi(lineNumber.c_str())-1;
+            int lineIdx = atoi(prefix + 10)-1;
             if ( lineIdx >= 0 )
               {
-              while ( vec.size() <= static_cast<size_t>(lineIdx) )
+              if ( vec.size() <= static_cast<size_t>(lineIdx) )
                 {
-                vec.push_back(-1);
+                vec.resize(lineIdx + 1, -1);
                 }
 
               // Initially all entries are -1 (not used). If we get coverage
               // information, increment it to 0 first.
               if ( vec[lineIdx] < 0 )
                 {
-                if ( cov > 0 || prefix.find("#") != prefix.npos )
+                if ( cov > 0 || memchr(prefix, '#', 12) )
                   {
                   vec[lineIdx] = 0;
                   }
@@ -1285,26 +1425,27 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
       if ( !sourceFile.empty() && actualSourceFile.empty() )
         {
         gcovFile = "";
+        std::string fullSourceFile =
+          cmSystemTools::CollapseFullPath(sourceFile.c_str(),
+                                          run.Dir.c_str());
 
         // Is it in the source dir or the binary dir?
         //
-        if ( IsFileInDir(sourceFile, cont->SourceDir) )
+        if ( IsFileInDir(fullSourceFile, cont->SourceDir) )
           {
           cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, "   produced s: "
             << sourceFile << std::endl);
           *cont->OFS << "  produced in source dir: " << sourceFile
             << std::endl;
-          actualSourceFile
-            = cmSystemTools::CollapseFullPath(sourceFile.c_str());
+          actualSourceFile = fullSourceFile;
           }
-        else if ( IsFileInDir(sourceFile, cont->BinaryDir) )
+        else if ( IsFileInDir(fullSourceFile, cont->BinaryDir) )
           {
           cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, "   produced b: "
             << sourceFile << std::endl);
           *cont->OFS << "  produced in binary dir: " << sourceFile
             << std::endl;
-          actualSourceFile
-            = cmSystemTools::CollapseFullPath(sourceFile.c_str());
+          actualSourceFile = fullSourceFile;
           }
 
         if ( actualSourceFile.empty() )
@@ -1345,7 +1486,6 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
       }
     }
 
-  cmSystemTools::ChangeDirectory(currentDirectory.c_str());
   return file_count;
 }
 
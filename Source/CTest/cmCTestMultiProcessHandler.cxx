@@ -17,6 +17,7 @@
 #include <stdlib.h>
 #include <stack>
 #include <float.h>
+#include <math.h>
 #include <cmsys/FStream.hxx>
 
 class TestComparator
@@ -36,6 +37,23 @@ private:
   cmCTestMultiProcessHandler* Handler;
 };
 
+class TestPathComparator
+{
+public:
+  TestPathComparator(cmCTestMultiProcessHandler::PathCostMap const& cost)
+    : PathCost(cost) {}
+
+  // Sorts tests in descending order of the longest chain they start
+  bool operator() (int index1, int index2) const
+    {
+    return this->PathCost.find(index1)->second >
+      this->PathCost.find(index2)->second;
+    }
+
+private:
+  cmCTestMultiProcessHandler::PathCostMap const& PathCost;
+};
+
 cmCTestMultiProcessHandler::cmCTestMultiProcessHandler()
 {
   this->ParallelLevel = 1;
@@ -82,6 +100,19 @@ void cmCTestMultiProcessHandler::SetParallelLevel(size_t level)
   this->ParallelLevel = level < 1 ? 1 : level;
 }
 
+//---------------------------------------------------------
+void cmCTestMultiProcessHandler
+::SetResourcePools(std::map<std::string, size_t> const& pools)
+{
+  this->ResourcePools = pools;
+  this->ResourcesUsed.clear();
+  for(std::map<std::string, size_t>::const_iterator i = pools.begin();
+      i != pools.end(); ++i)
+    {
+    this->ResourcesUsed[i->first] = 0;
+    }
+}
+
 //---------------------------------------------------------
 void cmCTestMultiProcessHandler::RunTests()
 {
@@ -168,6 +199,19 @@ void cmCTestMultiProcessHandler::LockResources(int index)
     {
     this->LockedResources.insert(*i);
     }
+
+  bool changed = false;
+  for(std::map<std::string, size_t>::iterator i =
+      this->ResourcesUsed.begin(); i != this->ResourcesUsed.end(); ++i)
+    {
+    size_t demand = this->GetResourceDemand(index, i->first);
+    i->second += demand;
+    changed = changed || demand > 0;
+    }
+  if(changed)
+    {
+    this->PrintResourceUsage();
+    }
 }
 
 //---------------------------------------------------------
@@ -179,6 +223,67 @@ void cmCTestMultiProcessHandler::UnlockResources(int index)
     {
     this->LockedResources.erase(*i);
     }
+
+  bool changed = false;
+  for(std::map<std::string, size_t>::iterator i =
+      this->ResourcesUsed.begin(); i != this->ResourcesUsed.end(); ++i)
+    {
+    size_t demand = this->GetResourceDemand(index, i->first);
+    i->second -= demand;
+    changed = changed || demand > 0;
+    }
+  if(changed)
+    {
+    this->PrintResourceUsage();
+    }
+}
+
+//---------------------------------------------------------
+size_t cmCTestMultiProcessHandler::GetResourceDemand(int index,
+                                                     std::string const& pool)
+{
+  std::map<std::string, size_t> const& demands =
+    this->Properties[index]->ResourceDemands;
+  std::map<std::string, size_t>::const_iterator d = demands.find(pool);
+  if(d == demands.end())
+    {
+    return 0;
+    }
+  //A test asking for more than the whole pool gets all of it,
+  //like a PROCESSORS setting higher than the -j setting.
+  size_t capacity = this->ResourcePools[pool];
+  return d->second > capacity ? capacity : d->second;
+}
+
+//---------------------------------------------------------
+bool cmCTestMultiProcessHandler::ResourcesAvailable(int index)
+{
+  for(std::map<std::string, size_t>::iterator i =
+      this->ResourcesUsed.begin(); i != this->ResourcesUsed.end(); ++i)
+    {
+    if(i->second + this->GetResourceDemand(index, i->first) >
+       this->ResourcePools[i->first])
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//---------------------------------------------------------
+void cmCTestMultiProcessHandler::PrintResourceUsage()
+{
+  cmOStringStream out;
+  out << "Resource pool usage:";
+  const char* sep = " ";
+  for(std::map<std::string, size_t>::iterator i =
+      this->ResourcesUsed.begin(); i != this->ResourcesUsed.end(); ++i)
+    {
+    out << sep << i->first << " " << i->second << "/"
+        << this->ResourcePools[i->first];
+    sep = ", ";
+    }
+  cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, out.str() << std::endl);
 }
 
 //---------------------------------------------------------
@@ -218,6 +323,11 @@ bool cmCTestMultiProcessHandler::StartTest(int test)
       return false;
       }
     }
+  //Check that the resource pools have room for the test
+  if(!this->ResourcesAvailable(test))
+    {
+    return false;
+    }
 
   // if there are no depends left then run this test
   if(this->Tests[test].empty())
@@ -274,15 +384,38 @@ bool cmCTestMultiProcessHandler::CheckOutput()
     }
   std::vector<cmCTestRunTest*> finished;
   std::string out, err;
+
+  // Collect output that is already available from every test without
+  // blocking so that tests which have exited are noticed right away.
   for(std::set<cmCTestRunTest*>::const_iterator i = this->RunningTests.begin();
       i != this->RunningTests.end(); ++i)
     {
     cmCTestRunTest* p = *i;
-    if(!p->CheckOutput())
+    if(!p->CheckOutput(0))
       {
       finished.push_back(p);
       }
     }
+
+  // If no test has finished, wait until any of them has output or
+  // exits, so that its slot can be given to the next test right away.
+  if(finished.empty())
+    {
+    std::vector<cmCTestRunTest*> tests;
+    std::vector<cmProcess*> processes;
+    for(std::set<cmCTestRunTest*>::const_iterator
+          i = this->RunningTests.begin();
+        i != this->RunningTests.end(); ++i)
+      {
+      tests.push_back(*i);
+      processes.push_back((*i)->GetProcess());
+      }
+    int ready = cmProcess::WaitForAny(processes, 0.1);
+    if(ready >= 0 && !tests[ready]->CheckOutput(0))
+      {
+      finished.push_back(tests[ready]);
+      }
+    }
   for( std::vector<cmCTestRunTest*>::iterator i = finished.begin();
        i != finished.end(); ++i)
     {
@@ -335,24 +468,22 @@ void cmCTestMultiProcessHandler::UpdateCostData()
       if(line == "---") break;
       std::vector<cmsys::String> parts =
         cmSystemTools::SplitString(line.c_str(), ' ');
-      //Format: <name> <previous_runs> <avg_cost>
+      //Format: <name> <previous_runs> <avg_cost> [<cost_variance>]
       if(parts.size() < 3) break;
 
       std::string name = parts[0];
-      int prev = atoi(parts[1].c_str());
-      float cost = static_cast<float>(atof(parts[2].c_str()));
-
       int index = this->SearchByName(name);
       if(index == -1)
         {
         // This test is not in memory. We just rewrite the entry
-        fout << name << " " << prev << " " << cost << "\n";
+        fout << line << "\n";
         }
       else
         {
         // Update with our new average cost
         fout << name << " " << this->Properties[index]->PreviousRuns << " "
-          << this->Properties[index]->Cost << "\n";
+          << this->Properties[index]->Cost << " "
+          << this->Properties[index]->CostVariance << "\n";
         temp.erase(index);
         }
       }
@@ -364,7 +495,7 @@ void cmCTestMultiProcessHandler::UpdateCostData()
   for(PropertiesMap::iterator i = temp.begin(); i != temp.end(); ++i)
     {
     fout << i->second->Name << " " << i->second->PreviousRuns << " "
-      << i->second->Cost << "\n";
+      << i->second->Cost << " " << i->second->CostVariance << "\n";
     }
 
   // Write list of failed tests
@@ -405,6 +536,11 @@ void cmCTestMultiProcessHandler::ReadCostData()
       std::string name = parts[0];
       int prev = atoi(parts[1].c_str());
       float cost = static_cast<float>(atof(parts[2].c_str()));
+      float variance = 0;
+      if(parts.size() > 3)
+        {
+        variance = static_cast<float>(atof(parts[3].c_str()));
+        }
 
       int index = this->SearchByName(name);
       if(index == -1) continue;
@@ -416,6 +552,7 @@ void cmCTestMultiProcessHandler::ReadCostData()
          this->Properties[index]->Cost == 0)
         {
         this->Properties[index]->Cost = cost;
+        this->Properties[index]->CostVariance = variance;
         }
       }
     // Next part of the file is the failed tests
@@ -462,11 +599,7 @@ void cmCTestMultiProcessHandler::CreateTestCostList()
 //---------------------------------------------------------
 void cmCTestMultiProcessHandler::CreateParallelTestCostList()
 {
-  TestSet alreadySortedTests;
-
-  std::list<TestSet> priorityStack;
-  priorityStack.push_back(TestSet());
-  TestSet &topLevel = priorityStack.back();
+  TestSet topLevel;
 
   // In parallel test runs add previously failed tests to the front
   // of the cost list and queue other tests for further sorting
@@ -478,7 +611,6 @@ void cmCTestMultiProcessHandler::CreateParallelTestCostList()
       {
       //If the test failed last time, it should be run first.
       this->SortedTests.push_back(i->first);
-      alreadySortedTests.insert(i->first);
       }
     else
       {
@@ -486,64 +618,67 @@ void cmCTestMultiProcessHandler::CreateParallelTestCostList()
       }
     }
 
-  // In parallel test runs repeatedly move dependencies of the tests on
-  // the current dependency level to the next level until no
-  // further dependencies exist.
-  while(priorityStack.back().size())
+  // Find the tests that wait on each test.
+  TestMap dependents;
+  for(TestMap::const_iterator i = this->Tests.begin();
+    i != this->Tests.end(); ++i)
     {
-    TestSet &previousSet = priorityStack.back();
-    priorityStack.push_back(TestSet());
-    TestSet &currentSet = priorityStack.back();
-
-    for(TestSet::const_iterator i = previousSet.begin();
-      i != previousSet.end(); ++i)
+    for(TestSet::const_iterator j = i->second.begin();
+      j != i->second.end(); ++j)
       {
-      TestSet const& dependencies = this->Tests[*i];
-      for(TestSet::const_iterator j = dependencies.begin();
-        j != dependencies.end(); ++j)
-        {
-        currentSet.insert(*j);
-        }
-      }
-
-    for(TestSet::const_iterator i = currentSet.begin();
-      i != currentSet.end(); ++i)
-      {
-      previousSet.erase(*i);
+      dependents[*j].insert(i->first);
       }
     }
 
-  // Remove the empty dependency level
-  priorityStack.pop_back();
-
-  // Reverse iterate over the different dependency levels (deepest first).
-  // Sort tests within each level by COST and append them to the cost list.
-  for(std::list<TestSet>::reverse_iterator i = priorityStack.rbegin();
-    i != priorityStack.rend(); ++i)
+  // Estimate how long each test and the longest chain of tests waiting
+  // on it will take, and start the tests heading the longest chains
+  // first so that a run does not end with one long chain of tests.
+  PathCostMap pathCost;
+  TestList sortedCopy;
+  for(TestSet::const_iterator i = topLevel.begin();
+    i != topLevel.end(); ++i)
     {
-    TestSet const& currentSet = *i;
-    TestComparator comp(this);
+    this->ComputePathCost(*i, dependents, pathCost);
+    sortedCopy.push_back(*i);
+    }
 
-    TestList sortedCopy;
+  TestPathComparator comp(pathCost);
+  std::stable_sort(sortedCopy.begin(), sortedCopy.end(), comp);
 
-    for(TestSet::const_iterator j = currentSet.begin();
-      j != currentSet.end(); ++j)
-      {
-      sortedCopy.push_back(*j);
-      }
+  for(TestList::const_iterator j = sortedCopy.begin();
+    j != sortedCopy.end(); ++j)
+    {
+    this->SortedTests.push_back(*j);
+    }
+}
 
-    std::stable_sort(sortedCopy.begin(), sortedCopy.end(), comp);
+//---------------------------------------------------------
+cmCTestMultiProcessHandler::PathCost
+cmCTestMultiProcessHandler::ComputePathCost(int test, TestMap& dependents,
+                                            PathCostMap& pathCost)
+{
+  PathCostMap::const_iterator known = pathCost.find(test);
+  if(known != pathCost.end())
+    {
+    return known->second;
+    }
 
-    for(TestList::const_iterator j = sortedCopy.begin();
-      j != sortedCopy.end(); ++j)
-      {
-      if(alreadySortedTests.find(*j) == alreadySortedTests.end())
-        {
-        this->SortedTests.push_back(*j);
-        alreadySortedTests.insert(*j);
-        }
-      }
+  // Tests with an unsteady run time are scheduled as if they take one
+  // standard deviation longer than average.
+  // Chains of tests with no recorded cost are ordered by length.
+  cmCTestTestHandler::cmCTestTestProperties* p = this->Properties[test];
+  PathCost longest(0, 0);
+  TestSet const& waiting = dependents[test];
+  for(TestSet::const_iterator i = waiting.begin(); i != waiting.end(); ++i)
+    {
+    longest = std::max(longest,
+                       this->ComputePathCost(*i, dependents, pathCost));
     }
+  PathCost cost(longest.first + p->Cost +
+                sqrt(std::max(static_cast<double>(p->CostVariance), 0.0)),
+                longest.second + 1);
+  pathCost[test] = cost;
+  return cost;
 }
 
 //---------------------------------------------------------
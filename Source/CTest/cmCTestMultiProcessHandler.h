@@ -30,6 +30,8 @@ public:
   struct TestList : public std::vector<int> {};
   struct PropertiesMap : public
      std::map<int, cmCTestTestHandler::cmCTestTestProperties*> {};
+  typedef std::pair<double, size_t> PathCost;
+  typedef std::map<int, PathCost> PathCostMap;
 
   cmCTestMultiProcessHandler();
   virtual ~cmCTestMultiProcessHandler();
@@ -37,6 +39,8 @@ public:
   void SetTests(TestMap& tests, PropertiesMap& properties);
   // Set the max number of tests that can be run at the same time.
   void SetParallelLevel(size_t);
+  // Set the capacity of each resource pool tests may draw from.
+  void SetResourcePools(std::map<std::string, size_t> const& pools);
   virtual void RunTests();
   void PrintTestList();
   void PrintLabels();
@@ -77,6 +81,10 @@ protected:
   void CreateSerialTestCostList();
 
   void CreateParallelTestCostList();
+  // Return the cost of a test plus the longest chain of tests waiting
+  // on it, and the number of tests in that chain.
+  PathCost ComputePathCost(int test, TestMap& dependents,
+                           PathCostMap& pathCost);
 
   // Removes the checkpoint file
   void MarkFinished();
@@ -94,6 +102,10 @@ protected:
 
   void LockResources(int index);
   void UnlockResources(int index);
+  // Amount of a resource pool used by a test, at most the pool capacity
+  size_t GetResourceDemand(int index, std::string const& pool);
+  bool ResourcesAvailable(int index);
+  void PrintResourceUsage();
   // map from test number to set of depend tests
   TestMap Tests;
   TestList SortedTests;
@@ -112,6 +124,8 @@ protected:
   std::vector<std::string>* Failed;
   std::vector<std::string> LastTestsFailed;
   std::set<std::string> LockedResources;
+  std::map<std::string, size_t> ResourcePools;
+  std::map<std::string, size_t> ResourcesUsed;
   std::vector<cmCTestTestHandler::cmCTestTestResult>* TestResults;
   size_t ParallelLevel; // max number of process that can be run at once
   std::set<cmCTestRunTest*> RunningTests;  // current running tests
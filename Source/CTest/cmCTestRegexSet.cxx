@@ -0,0 +1,344 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2014 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmCTestRegexSet.h"
+
+#include <deque>
+
+//----------------------------------------------------------------------
+cmCTestRegexSet::cmCTestRegexSet()
+{
+  this->Built = false;
+  this->ScanCount = 0;
+  this->Line = "";
+}
+
+//----------------------------------------------------------------------
+void cmCTestRegexSet::Clear()
+{
+  this->Entries.clear();
+  this->Literals.clear();
+  this->LiteralIndex.clear();
+  this->Built = false;
+  this->Line = "";
+}
+
+//----------------------------------------------------------------------
+int cmCTestRegexSet::Add(const char* regex)
+{
+  Entry e;
+  e.Literal = -1;
+  // Build output lines can be very long, so match in linear time.
+  e.Regex.set_engine(cmsys::RegularExpression::Linear);
+  if(e.Regex.compile(regex))
+    {
+    std::string literal = cmCTestRegexSet::GetRequiredLiteral(regex);
+    if(!literal.empty())
+      {
+      std::map<std::string, int>::iterator i =
+        this->LiteralIndex.find(literal);
+      if(i == this->LiteralIndex.end())
+        {
+        i = this->LiteralIndex.insert(
+          std::make_pair(literal, static_cast<int>(this->Literals.size())))
+          .first;
+        this->Literals.push_back(literal);
+        }
+      e.Literal = i->second;
+      }
+    }
+  this->Entries.push_back(e);
+  this->Built = false;
+  return static_cast<int>(this->Entries.size()) - 1;
+}
+
+//----------------------------------------------------------------------
+void cmCTestRegexSet::Scan(const char* line)
+{
+  if(!this->Built)
+    {
+    this->Build();
+    }
+  this->Line = line;
+  if(++this->ScanCount == 0)
+    {
+    std::fill(this->Seen.begin(), this->Seen.end(), 0u);
+    this->ScanCount = 1;
+    }
+  if(this->Literals.empty())
+    {
+    return;
+    }
+
+  int state = 0;
+  for(const unsigned char* c = reinterpret_cast<const unsigned char*>(line);
+      *c; ++c)
+    {
+    state = this->Goto[state * 256 + *c];
+    int out = this->Output[state] >= 0? state : this->OutputLink[state];
+    for(; out >= 0; out = this->OutputLink[out])
+      {
+      this->Seen[this->Output[out]] = this->ScanCount;
+      }
+    }
+}
+
+//----------------------------------------------------------------------
+int cmCTestRegexSet::Find(int begin, int end)
+{
+  for(int i = begin; i < end; ++i)
+    {
+    Entry& e = this->Entries[i];
+    if(!e.Regex.is_valid())
+      {
+      continue;
+      }
+    if(e.Literal >= 0 && this->Seen[e.Literal] != this->ScanCount)
+      {
+      // A required literal is missing so this cannot match.
+      continue;
+      }
+    if(e.Regex.find(this->Line))
+      {
+      return i;
+      }
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------
+void cmCTestRegexSet::Build()
+{
+  this->Goto.assign(256, -1);
+  this->Output.assign(1, -1);
+  this->OutputLink.assign(1, -1);
+
+  // Start with a trie of all literals.
+  for(size_t l = 0; l < this->Literals.size(); ++l)
+    {
+    std::string const& literal = this->Literals[l];
+    int state = 0;
+    for(std::string::const_iterator c = literal.begin();
+        c != literal.end(); ++c)
+      {
+      int& next = this->Goto[state * 256 + static_cast<unsigned char>(*c)];
+      if(next < 0)
+        {
+        next = static_cast<int>(this->Output.size());
+        this->Goto.resize(this->Goto.size() + 256, -1);
+        this->Output.push_back(-1);
+        this->OutputLink.push_back(-1);
+        }
+      state = this->Goto[state * 256 + static_cast<unsigned char>(*c)];
+      }
+    this->Output[state] = static_cast<int>(l);
+    }
+
+  // Fill in failure transitions breadth-first so every state has a
+  // transition for every character.
+  std::vector<int> fail(this->Output.size(), 0);
+  std::deque<int> queue;
+  for(int c = 0; c < 256; ++c)
+    {
+    int& next = this->Goto[c];
+    if(next < 0)
+      {
+      next = 0;
+      }
+    else
+      {
+      queue.push_back(next);
+      }
+    }
+  while(!queue.empty())
+    {
+    int state = queue.front();
+    queue.pop_front();
+    for(int c = 0; c < 256; ++c)
+      {
+      int next = this->Goto[state * 256 + c];
+      int fallback = this->Goto[fail[state] * 256 + c];
+      if(next < 0)
+        {
+        this->Goto[state * 256 + c] = fallback;
+        continue;
+        }
+      fail[next] = fallback;
+      this->OutputLink[next] = this->Output[fallback] >= 0?
+        fallback : this->OutputLink[fallback];
+      queue.push_back(next);
+      }
+    }
+
+  this->Seen.assign(this->Literals.size(), 0);
+  this->ScanCount = 0;
+  this->Built = true;
+}
+
+//----------------------------------------------------------------------
+// Return the ']' that closes the set starting at the '[' p points to, or
+// 0 if the set is not closed.  Like the KWSys compiler, take a ']' or '-'
+// right after the '[' or '[^' literally.
+static const char* cmCTestRegexSetSkipSet(const char* p)
+{
+  ++p;
+  if(*p == '^')
+    {
+    ++p;
+    }
+  if(*p == ']' || *p == '-')
+    {
+    ++p;
+    }
+  while(*p && *p != ']')
+    {
+    ++p;
+    }
+  return *p? p : 0;
+}
+
+//----------------------------------------------------------------------
+// Walk the expression the way the KWSys compiler parses it and collect
+// runs of characters that every match must contain in sequence.  Anything
+// optional, repeated, grouped or matching a set of characters ends a run.
+std::string cmCTestRegexSet::GetRequiredLiteral(const char* regex)
+{
+  // An alternative at the top level means nothing is required.
+  int depth = 0;
+  const char* p;
+  for(p = regex; *p; ++p)
+    {
+    if(*p == '\\')
+      {
+      if(!*++p)
+        {
+        return "";
+        }
+      }
+    else if(*p == '[')
+      {
+      if(!(p = cmCTestRegexSetSkipSet(p)))
+        {
+        return "";
+        }
+      }
+    else if(*p == '(')
+      {
+      ++depth;
+      }
+    else if(*p == ')')
+      {
+      --depth;
+      }
+    else if(*p == '|' && depth == 0)
+      {
+      return "";
+      }
+    }
+
+  std::string best;
+  std::string run;
+  for(p = regex; *p;)
+    {
+    bool literal = false;
+    char ch = 0;
+    const char* next = p + 1;
+    switch(*p)
+      {
+      case '\\':
+        literal = true;
+        ch = p[1];
+        next = p + 2;
+        break;
+      case '[':
+        // The first pass checked that every set is closed.
+        next = cmCTestRegexSetSkipSet(p) + 1;
+        break;
+      case '(':
+        for(depth = 1; depth > 0 && *next; ++next)
+          {
+          if(*next == '\\' && next[1])
+            {
+            ++next;
+            }
+          else if(*next == '[')
+            {
+            next = cmCTestRegexSetSkipSet(next);
+            }
+          else if(*next == '(')
+            {
+            ++depth;
+            }
+          else if(*next == ')')
+            {
+            --depth;
+            }
+          }
+        break;
+      case '.':
+      case '^':
+      case '$':
+        break;
+      case '*':
+      case '+':
+      case '?':
+      case ')':
+        // Not valid here; the expression will not compile anyway.
+        return "";
+      default:
+        literal = true;
+        ch = *p;
+        break;
+      }
+
+    char op = *next;
+    if(op == '*' || op == '+' || op == '?')
+      {
+      ++next;
+      }
+    else
+      {
+      op = 0;
+      }
+
+    if(literal && !op)
+      {
+      run += ch;
+      }
+    else
+      {
+      if(literal && op == '+')
+        {
+        // The last repetition is followed by whatever comes next.
+        run += ch;
+        if(run.size() > best.size())
+          {
+          best = run;
+          }
+        run = ch;
+        }
+      else
+        {
+        if(run.size() > best.size())
+          {
+          best = run;
+          }
+        run = "";
+        }
+      }
+    p = next;
+    }
+  if(run.size() > best.size())
+    {
+    best = run;
+    }
+  return best;
+}
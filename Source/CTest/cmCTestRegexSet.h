@@ -0,0 +1,77 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2014 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmCTestRegexSet_h
+#define cmCTestRegexSet_h
+
+#include "cmStandardIncludes.h"
+
+#include <cmsys/RegularExpression.hxx>
+
+/** \class cmCTestRegexSet
+ * \brief Match one line against many regular expressions.
+ *
+ * Each expression is reduced to the longest literal string every match
+ * of it must contain.  Scan() runs one Aho-Corasick automaton built from
+ * all those literals over the line, and Find() then only runs the
+ * expressions whose literal occurs in the line or that have none.
+ */
+class cmCTestRegexSet
+{
+public:
+  cmCTestRegexSet();
+
+  /** Remove all expressions.  */
+  void Clear();
+
+  /** Append an expression and return its index.  An expression that
+      does not compile keeps its index but never matches.  */
+  int Add(const char* regex);
+
+  /** Number of expressions added.  */
+  int GetSize() const { return static_cast<int>(this->Entries.size()); }
+
+  /** Look for the literals of all expressions in a line.  The line must
+      stay valid while Find() is used on it.  */
+  void Scan(const char* line);
+
+  /** Index of the first expression in [begin, end) that matches the line
+      last given to Scan(), or -1 if none does.  */
+  int Find(int begin, int end);
+
+  /** Longest literal string every match of an expression contains.  */
+  static std::string GetRequiredLiteral(const char* regex);
+
+private:
+  struct Entry
+  {
+    cmsys::RegularExpression Regex;
+    int Literal;        // Index into Literals, or -1 for none.
+  };
+  std::vector<Entry> Entries;
+  std::vector<std::string> Literals;
+  std::map<std::string, int> LiteralIndex;
+
+  // Aho-Corasick automaton over Literals with a full transition table.
+  void Build();
+  bool Built;
+  std::vector<int> Goto;
+  std::vector<int> Output;      // Literal ending at a state, or -1.
+  std::vector<int> OutputLink;  // Next state along failure links with
+                                // an output, or -1.
+
+  // Literals seen by the last Scan() are stamped with ScanCount.
+  std::vector<unsigned int> Seen;
+  unsigned int ScanCount;
+  const char* Line;
+};
+
+#endif
@@ -19,6 +19,8 @@
 #include <cm_zlib.h>
 #include <cmsys/Base64.h>
 
+#include <ctype.h>
+
 cmCTestRunTest::cmCTestRunTest(cmCTestTestHandler* handler)
 {
   this->CTest = handler->CTest;
@@ -31,6 +33,12 @@ cmCTestRunTest::cmCTestRunTest(cmCTestTestHandler* handler)
   this->TestResult.Properties = 0;
   this->ProcessOutput = "";
   this->CompressedOutput = "";
+  this->OutputLimit = 0;
+  this->OutputTailStart = 0;
+  this->OutputOmitted = 0;
+  this->OutputInFile = false;
+  this->FullOutputRequested = false;
+  this->InMeasurement = false;
   this->CompressionRatio = 2;
   this->StopTimePassed = false;
 }
@@ -40,13 +48,14 @@ cmCTestRunTest::~cmCTestRunTest()
 }
 
 //----------------------------------------------------------------------------
-bool cmCTestRunTest::CheckOutput()
+bool cmCTestRunTest::CheckOutput(double timeout)
 {
-  // Read lines for up to 0.1 seconds of total time.
-  double timeout = 0.1;
-  double timeEnd = cmSystemTools::GetTime() + timeout;
+  // Read lines for up to the given amount of total time.  Without a
+  // timeout keep reading lines that are already available, but not
+  // for so long that other tests are starved.
+  double timeEnd = cmSystemTools::GetTime() + (timeout > 0? timeout : 0.1);
   std::string line;
-  while((timeout = timeEnd - cmSystemTools::GetTime(), timeout > 0))
+  for(;;)
     {
     int p = this->TestProcess->GetNextOutputLine(line, timeout);
     if(p == cmsysProcess_Pipe_None)
@@ -60,17 +69,187 @@ bool cmCTestRunTest::CheckOutput()
       // Store this line of output.
       cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                  this->GetIndex() << ": " << line << std::endl);
-      this->ProcessOutput += line;
-      this->ProcessOutput += "\n";
+      this->StoreOutput(line);
       }
     else // if(p == cmsysProcess_Pipe_Timeout)
       {
       break;
       }
+    double left = timeEnd - cmSystemTools::GetTime();
+    if(left <= 0)
+      {
+      break;
+      }
+    if(timeout > 0)
+      {
+      timeout = left;
+      }
     }
   return true;
 }
 
+//----------------------------------------------------------------------------
+void cmCTestRunTest::StoreOutput(std::string const& line)
+{
+  std::string text = line + "\n";
+  if(this->FullOutput.is_open())
+    {
+    this->FullOutput << text;
+    }
+  if(!this->OutputLimit)
+    {
+    this->ProcessOutput += text;
+    return;
+    }
+
+  // Look for what is taken from all of the output, not only from the
+  // part that is kept.
+  if(line.find("CTEST_FULL_OUTPUT") != line.npos)
+    {
+    this->FullOutputRequested = true;
+    }
+  this->ScanMeasurements(text);
+
+  // Fill the head first, then keep the rest in the tail.
+  size_t head = 0;
+  if(this->ProcessOutput.size() < this->OutputLimit)
+    {
+    head = std::min(this->OutputLimit - this->ProcessOutput.size(),
+                    text.size());
+    this->ProcessOutput.append(text, 0, head);
+    }
+  if(head == text.size())
+    {
+    return;
+    }
+
+  // Save everything seen so far before the tail starts to drop any.
+  if(this->FullOutputFile.empty() &&
+     this->OutputTail.size() + text.size() - head > this->OutputLimit)
+    {
+    cmOStringStream fname;
+    fname << this->CTest->GetBinaryDir() << "/Testing/Temporary/TestOutput_"
+          << this->Index << ".log";
+    this->FullOutputFile = fname.str();
+    this->FullOutput.open(this->FullOutputFile.c_str(),
+                          std::ios::out | std::ios::binary);
+    this->OutputInFile = this->FullOutput.is_open();
+    this->FullOutput << this->ProcessOutput.substr(0,
+                          this->ProcessOutput.size() - head)
+                     << this->OutputTail << text;
+    }
+  this->StoreOutputTail(text.c_str() + head, text.size() - head);
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::ScanMeasurements(std::string const& text)
+{
+  // Find the same tags as DartStuff1 in cmCTestTestHandler:
+  // <DartMeasurement[^<]*</DartMeasurement[a-zA-Z]*>
+  static const char start[] = "<DartMeasurement";
+  static const char close[] = "</DartMeasurement";
+  std::string::size_type pos = 0;
+  while(pos < text.size())
+    {
+    if(!this->InMeasurement)
+      {
+      pos = text.find(start, pos);
+      if(pos == text.npos)
+        {
+        return;
+        }
+      this->InMeasurement = true;
+      this->PendingMeasurement = "<";
+      ++pos;
+      continue;
+      }
+    std::string::size_type lt = text.find('<', pos);
+    this->PendingMeasurement.append(text, pos,
+      lt == text.npos ? text.npos : lt - pos);
+    if(lt == text.npos)
+      {
+      return;
+      }
+    this->InMeasurement = false;
+    pos = lt;
+    if(text.compare(lt, sizeof(close) - 1, close) == 0)
+      {
+      std::string::size_type end = lt + sizeof(close) - 1;
+      while(end < text.size() && isalpha(static_cast<unsigned char>(text[end])))
+        {
+        ++end;
+        }
+      if(end < text.size() && text[end] == '>')
+        {
+        ++end;
+        this->PendingMeasurement.append(text, lt, end - lt);
+        this->Measurements += this->PendingMeasurement;
+        pos = end;
+        }
+      }
+    this->PendingMeasurement = "";
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::StoreOutputTail(const char* data, size_t length)
+{
+  size_t const limit = this->OutputLimit;
+  if(length >= limit)
+    {
+    this->OutputOmitted += this->OutputTail.size() + length - limit;
+    this->OutputTail.assign(data + length - limit, limit);
+    this->OutputTailStart = 0;
+    return;
+    }
+  while(length > 0)
+    {
+    size_t n;
+    if(this->OutputTail.size() < limit)
+      {
+      n = std::min(limit - this->OutputTail.size(), length);
+      this->OutputTail.append(data, n);
+      }
+    else
+      {
+      // Overwrite the oldest bytes.
+      n = std::min(limit - this->OutputTailStart, length);
+      this->OutputTail.replace(this->OutputTailStart, n, data, n);
+      this->OutputTailStart = (this->OutputTailStart + n) % limit;
+      this->OutputOmitted += n;
+      }
+    data += n;
+    length -= n;
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::FinishOutput()
+{
+  if(this->OutputOmitted)
+    {
+    cmOStringStream msg;
+    msg << "\n...\n" << this->OutputOmitted
+        << " bytes of test output were omitted here.";
+    if(this->OutputInFile && this->TestHandler->KeepFullTestOutput)
+      {
+      msg << "  The full output is in \"" << this->FullOutputFile << "\".";
+      }
+    msg << "\n...\n";
+    this->ProcessOutput += msg.str();
+    }
+  this->ProcessOutput.append(this->OutputTail, this->OutputTailStart,
+                             std::string::npos);
+  this->ProcessOutput.append(this->OutputTail, 0, this->OutputTailStart);
+  this->OutputTail = "";
+  this->OutputTailStart = 0;
+  this->OutputOmitted = 0;
+  if(this->FullOutput.is_open())
+    {
+    this->FullOutput.close();
+    }
+}
+
 //---------------------------------------------------------
 // Streamed compression of test output.  The compressed data
 // is appended to this->CompressedOutput
@@ -79,64 +258,102 @@ void cmCTestRunTest::CompressOutput()
   int ret;
   z_stream strm;
 
-  unsigned char* in =
-    reinterpret_cast<unsigned char*>(
-    const_cast<char*>(this->ProcessOutput.c_str()));
-  //zlib makes the guarantee that this is the maximum output size
-  int outSize = static_cast<int>(
-    static_cast<double>(this->ProcessOutput.size()) * 1.001 + 13.0);
-  unsigned char* out = new unsigned char[outSize];
-
   strm.zalloc = Z_NULL;
   strm.zfree = Z_NULL;
   strm.opaque = Z_NULL;
   ret = deflateInit(&strm, -1); //default compression level
   if (ret != Z_OK)
     {
-    delete[] out;
     return;
     }
 
-  strm.avail_in = static_cast<uInt>(this->ProcessOutput.size());
-  strm.next_in = in;
-  strm.avail_out = outSize;
-  strm.next_out = out;
-  ret = deflate(&strm, Z_FINISH);
+  // Compress the output kept in memory, or all of it from its file if
+  // only part of it was kept.
+  cmsys::ifstream fin;
+  if(this->OutputInFile)
+    {
+    fin.open(this->FullOutputFile.c_str(), std::ios::in | std::ios::binary);
+    }
+  else
+    {
+    strm.next_in = reinterpret_cast<unsigned char*>(
+      const_cast<char*>(this->ProcessOutput.c_str()));
+    strm.avail_in = static_cast<uInt>(this->ProcessOutput.size());
+    }
 
-  if(ret == Z_STREAM_ERROR || ret != Z_STREAM_END)
+  std::vector<unsigned char> out;
+  unsigned char outBuffer[16384];
+  char inBuffer[16384];
+  int flush = Z_NO_FLUSH;
+  while(flush != Z_FINISH && ret != Z_STREAM_ERROR)
+    {
+    flush = Z_FINISH;
+    if(this->OutputInFile)
+      {
+      fin.read(inBuffer, sizeof(inBuffer));
+      strm.next_in = reinterpret_cast<unsigned char*>(inBuffer);
+      strm.avail_in = static_cast<uInt>(fin.gcount());
+      if(fin)
+        {
+        flush = Z_NO_FLUSH;
+        }
+      }
+    do
+      {
+      strm.avail_out = sizeof(outBuffer);
+      strm.next_out = outBuffer;
+      ret = deflate(&strm, flush);
+      out.insert(out.end(), outBuffer,
+                 outBuffer + sizeof(outBuffer) - strm.avail_out);
+      }
+    while(strm.avail_out == 0 && ret != Z_STREAM_ERROR);
+    }
+
+  if(ret != Z_STREAM_END || (this->OutputInFile && !fin.eof()))
     {
     cmCTestLog(this->CTest, ERROR_MESSAGE, "Error during output "
       "compression. Sending uncompressed output." << std::endl);
-    delete[] out;
+    (void)deflateEnd(&strm);
     return;
     }
 
   (void)deflateEnd(&strm);
 
-  unsigned char *encoded_buffer
-    = new unsigned char[static_cast<int>(outSize * 1.5)];
+  std::vector<unsigned char> encoded_buffer(out.size() * 3 / 2 + 4);
 
   unsigned long rlen
-    = cmsysBase64_Encode(out, strm.total_out, encoded_buffer, 1);
+    = cmsysBase64_Encode(&out[0], static_cast<unsigned long>(out.size()),
+                         &encoded_buffer[0], 1);
 
-  for(unsigned long i = 0; i < rlen; i++)
-    {
-    this->CompressedOutput += encoded_buffer[i];
-    }
+  this->CompressedOutput.append(
+    reinterpret_cast<char*>(&encoded_buffer[0]), rlen);
 
   if(strm.total_in)
     {
     this->CompressionRatio = static_cast<double>(strm.total_out) /
                              static_cast<double>(strm.total_in);
     }
-
-  delete [] encoded_buffer;
-  delete [] out;
 }
 
 //---------------------------------------------------------
 bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
 {
+  this->FinishOutput();
+  // A test asking for its full output gets it even if only part of it
+  // was kept while it ran.
+  if(this->OutputInFile && this->FullOutputRequested)
+    {
+    cmsys::ifstream fin(this->FullOutputFile.c_str(),
+                        std::ios::in | std::ios::binary);
+    if(fin)
+      {
+      cmOStringStream full;
+      full << fin.rdbuf();
+      this->ProcessOutput = full.str();
+      this->Measurements = "";
+      this->OutputInFile = false;
+      }
+    }
   if ((!this->TestHandler->MemCheck &&
       this->CTest->ShouldCompressTestOutput()) ||
       (this->TestHandler->MemCheck &&
@@ -144,6 +361,10 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
     {
     this->CompressOutput();
     }
+  if(!this->FullOutputFile.empty() && !this->TestHandler->KeepFullTestOutput)
+    {
+    cmSystemTools::RemoveFile(this->FullOutputFile.c_str());
+    }
 
   this->WriteLogOutputTop(completed, total);
   std::string reason;
@@ -369,12 +590,19 @@ void cmCTestRunTest::ComputeWeightedCost()
 {
   double prev = static_cast<double>(this->TestProperties->PreviousRuns);
   double avgcost = static_cast<double>(this->TestProperties->Cost);
+  double variance = static_cast<double>(this->TestProperties->CostVariance);
   double current = this->TestResult.ExecutionTime;
 
+  // Average the first runs equally, then weight recent runs more so that
+  // the estimate follows tests whose run time changes.
   if(this->TestResult.Status == cmCTestTestHandler::COMPLETED)
     {
+    double weight = 1.0 / std::min(prev + 1.0, 10.0);
+    double diff = current - avgcost;
     this->TestProperties->Cost =
-      static_cast<float>(((prev * avgcost) + current) / (prev + 1.0));
+      static_cast<float>(avgcost + weight * diff);
+    this->TestProperties->CostVariance =
+      static_cast<float>((1.0 - weight) * (variance + weight * diff * diff));
     this->TestProperties->PreviousRuns++;
     }
 }
@@ -416,6 +644,17 @@ bool cmCTestRunTest::StartTest(size_t total)
   this->TestResult.Name = this->TestProperties->Name;
   this->TestResult.Path = this->TestProperties->Directory.c_str();
 
+  // While the test runs keep only as much of its output as can be
+  // reported, unless all of it is needed to check the test.
+  int maxPassed = this->TestHandler->CustomMaximumPassedTestOutputSize;
+  int maxFailed = this->TestHandler->CustomMaximumFailedTestOutputSize;
+  if(maxPassed > 0 && maxFailed > 0 && !this->TestHandler->MemCheck &&
+     this->TestProperties->RequiredRegularExpressions.empty() &&
+     this->TestProperties->ErrorRegularExpressions.empty())
+    {
+    this->OutputLimit = static_cast<size_t>(std::max(maxPassed, maxFailed));
+    }
+
   if(args.size() >= 2 && args[1] == "NOT_AVAILABLE")
     {
     this->TestProcess = new cmProcess;
@@ -545,6 +784,12 @@ void cmCTestRunTest::ComputeArguments()
 //----------------------------------------------------------------------
 void cmCTestRunTest::DartProcessing()
 {
+  if (!this->Measurements.empty())
+    {
+    // The measurements of limited output were collected as it arrived.
+    this->TestResult.RegressionImages
+      = this->TestHandler->GenerateRegressionImages(this->Measurements);
+    }
   if (!this->ProcessOutput.empty() &&
      this->ProcessOutput.find("<DartMeasurement") != this->ProcessOutput.npos)
     {
@@ -558,8 +803,11 @@ void cmCTestRunTest::DartProcessing()
         cmSystemTools::ReplaceString(this->ProcessOutput,
                          this->TestHandler->DartStuff1.match(1).c_str(), "");
         }
-      this->TestResult.RegressionImages
-        = this->TestHandler->GenerateRegressionImages(dartString);
+      if (this->Measurements.empty())
+        {
+        this->TestResult.RegressionImages
+          = this->TestHandler->GenerateRegressionImages(dartString);
+        }
       }
     }
 }
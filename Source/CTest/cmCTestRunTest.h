@@ -16,6 +16,8 @@
 #include <cmCTestTestHandler.h>
 #include <cmProcess.h>
 
+#include <cmsys/FStream.hxx>
+
 /** \class cmRunTest
  * \brief represents a single test to be run
  *
@@ -39,13 +41,18 @@ public:
 
   std::string GetProcessOutput() { return this->ProcessOutput; }
 
+  cmProcess* GetProcess() { return this->TestProcess; }
+
   bool IsStopTimePassed() { return this->StopTimePassed; }
 
   cmCTestTestHandler::cmCTestTestResult GetTestResults()
   { return this->TestResult; }
 
-  // Read and store output.  Returns true if it must be called again.
-  bool CheckOutput();
+  // Read and store output for up to the given number of seconds.
+  // A zero timeout reads only output that is already available, for
+  // no more than a tenth of a second.
+  // Returns true if it must be called again.
+  bool CheckOutput(double timeout);
 
   // Compresses the output, writing to CompressedOutput
   void CompressOutput();
@@ -68,6 +75,16 @@ private:
   void WriteLogOutputTop(size_t completed, size_t total);
   //Run post processing of the process output for MemCheck
   void MemCheckPostProcess();
+  // Store a line of output.  Once the output exceeds twice OutputLimit
+  // only its first and last OutputLimit bytes are kept in memory, and
+  // all of it is written to FullOutputFile.
+  void StoreOutput(std::string const& line);
+  void StoreOutputTail(const char* data, size_t length);
+  // Copy each complete <DartMeasurement> tag of the output to
+  // Measurements, since the tag may not be kept in ProcessOutput.
+  void ScanMeasurements(std::string const& text);
+  // Append the kept tail of the output to ProcessOutput.
+  void FinishOutput();
 
   cmCTestTestHandler::cmCTestTestProperties * TestProperties;
   //Pointer back to the "parent"; the handler that invoked this test run
@@ -84,6 +101,20 @@ private:
 
   std::string ProcessOutput;
   std::string CompressedOutput;
+  size_t OutputLimit;
+  // Most recent output, a ring buffer starting at OutputTailStart.
+  std::string OutputTail;
+  size_t OutputTailStart;
+  size_t OutputOmitted;
+  // Full copy of output too large to keep in memory.
+  std::string FullOutputFile;
+  cmsys::ofstream FullOutput;
+  bool OutputInFile;
+  bool FullOutputRequested;
+  // Measurements found in limited output, and one still being read.
+  std::string Measurements;
+  std::string PendingMeasurement;
+  bool InMeasurement;
   double CompressionRatio;
   //The test results
   cmCTestTestHandler::cmCTestTestResult TestResult;
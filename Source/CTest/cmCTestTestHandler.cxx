@@ -31,6 +31,7 @@
 #include "cm_utf8.h"
 
 #include <stdlib.h>
+#include <ctype.h>
 #include <math.h>
 #include <float.h>
 
@@ -391,6 +392,7 @@ cmCTestTestHandler::cmCTestTestHandler()
 
   this->CustomMaximumPassedTestOutputSize = 1 * 1024;
   this->CustomMaximumFailedTestOutputSize = 300 * 1024;
+  this->KeepFullTestOutput = false;
 
   this->MemCheck = false;
 
@@ -421,6 +423,7 @@ void cmCTestTestHandler::Initialize()
   this->CustomPostTest.clear();
   this->CustomMaximumPassedTestOutputSize = 1 * 1024;
   this->CustomMaximumFailedTestOutputSize = 300 * 1024;
+  this->KeepFullTestOutput = false;
 
   this->TestsToRun.clear();
 
@@ -455,6 +458,11 @@ void cmCTestTestHandler::PopulateCustomVectors(cmMakefile *mf)
   this->CTest->PopulateCustomInteger(mf,
                              "CTEST_CUSTOM_MAXIMUM_FAILED_TEST_OUTPUT_SIZE",
                              this->CustomMaximumFailedTestOutputSize);
+  if(const char* keep =
+     mf->GetDefinition("CTEST_CUSTOM_KEEP_FULL_TEST_OUTPUT"))
+    {
+    this->KeepFullTestOutput = cmSystemTools::IsOn(keep);
+    }
 }
 
 //----------------------------------------------------------------------
@@ -497,6 +505,17 @@ int cmCTestTestHandler::ProcessHandler()
     {
     this->CTest->SetParallelLevel(atoi(this->GetOption("ParallelLevel")));
     }
+  this->ResourcePools.clear();
+  if(const char* pools = this->GetOption("ResourcePools"))
+    {
+    if(!cmCTestTestHandler::ParseResourceAmounts(pools, this->ResourcePools))
+      {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+        "Invalid resource pool specification: " << pools << std::endl
+        << "Expected a list of <name>=<capacity> entries." << std::endl);
+      return -1;
+      }
+    }
 
   const char* val;
   val = this->GetOption("LabelRegularExpression");
@@ -1062,6 +1081,7 @@ void cmCTestTestHandler::ProcessDirectory(std::vector<std::string> &passed,
     new cmCTestBatchTestHandler : new cmCTestMultiProcessHandler;
   parallel->SetCTest(this->CTest);
   parallel->SetParallelLevel(this->CTest->GetParallelLevel());
+  parallel->SetResourcePools(this->ResourcePools);
   parallel->SetTestHandler(this);
 
   *this->LogFile << "Start testing: "
@@ -1549,6 +1569,36 @@ std::string cmCTestTestHandler
   return fullPath;
 }
 
+//----------------------------------------------------------------------
+bool cmCTestTestHandler
+::ParseResourceAmounts(std::string const& value,
+                       std::map<std::string, size_t>& amounts)
+{
+  bool result = true;
+  std::vector<std::string> entries;
+  cmSystemTools::ExpandListArgument(value, entries);
+  for(std::vector<std::string>::iterator e = entries.begin();
+      e != entries.end(); ++e)
+    {
+    std::string::size_type pos = e->find('=');
+    if(pos == std::string::npos || pos == 0 || pos + 1 == e->size() ||
+       !isdigit(static_cast<unsigned char>((*e)[pos + 1])))
+      {
+      result = false;
+      continue;
+      }
+    char* end = 0;
+    unsigned long amount = strtoul(e->c_str() + pos + 1, &end, 10);
+    if(*end)
+      {
+      result = false;
+      continue;
+      }
+    amounts[e->substr(0, pos)] = static_cast<size_t>(amount);
+    }
+  return result;
+}
+
 
 //----------------------------------------------------------------------
 void cmCTestTestHandler::GetListOfTests()
@@ -2184,6 +2234,16 @@ bool cmCTestTestHandler::SetTestsProperties(
               rtit->LockedResources.insert(*f);
               }
             }
+          if ( key == "RESOURCE_DEMANDS" )
+            {
+            if(!cmCTestTestHandler::ParseResourceAmounts(
+                 val, rtit->ResourceDemands))
+              {
+              cmCTestLog(this->CTest, WARNING,
+                "Invalid RESOURCE_DEMANDS value for test " << rtit->Name
+                << ": " << val << std::endl);
+              }
+            }
           if ( key == "TIMEOUT" )
             {
             rtit->Timeout = atof(val.c_str());
@@ -2371,6 +2431,7 @@ bool cmCTestTestHandler::AddTest(const std::vector<std::string>& args)
   test.Timeout = 0;
   test.ExplicitTimeout = false;
   test.Cost = 0;
+  test.CostVariance = 0;
   test.Processors = 1;
   test.SkipReturnCode = -1;
   test.PreviousRuns = 0;
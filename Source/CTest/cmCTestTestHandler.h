@@ -102,6 +102,7 @@ public:
     bool IsInBasedOnREOptions;
     bool WillFail;
     float Cost;
+    float CostVariance;
     int PreviousRuns;
     bool RunSerial;
     double Timeout;
@@ -114,6 +115,8 @@ public:
     std::vector<std::string> Environment;
     std::vector<std::string> Labels;
     std::set<std::string> LockedResources;
+    // amount of each resource pool used while the test runs
+    std::map<std::string, size_t> ResourceDemands;
   };
 
   struct cmCTestTestResult
@@ -156,6 +159,10 @@ public:
                                     std::vector<std::string> &extraPaths,
                                     std::vector<std::string> &failed);
 
+  // parse a list of <name>=<amount> entries, false if one is invalid
+  static bool ParseResourceAmounts(std::string const& value,
+                                   std::map<std::string, size_t>& amounts);
+
   typedef std::vector<cmCTestTestProperties> ListOfTests;
 protected:
   // compute a final test list
@@ -185,6 +192,8 @@ protected:
   bool MemCheck;
   int CustomMaximumPassedTestOutputSize;
   int CustomMaximumFailedTestOutputSize;
+  bool KeepFullTestOutput;
+  std::map<std::string, size_t> ResourcePools;
   int MaxIndex;
 public:
   enum { // Program statuses
@@ -67,6 +67,30 @@ bool cmProcess::StartProcess()
           == cmsysProcess_State_Executing);
 }
 
+//----------------------------------------------------------------------------
+int cmProcess::WaitForAny(std::vector<cmProcess*> const& processes,
+                          double timeout)
+{
+  // Lines already buffered can be read without waiting.
+  std::vector<cmsysProcess*> handles;
+  for(std::vector<cmProcess*>::size_type i = 0; i < processes.size(); ++i)
+    {
+    cmProcess* p = processes[i];
+    if(p->StdOut.HasUnscanned() || p->StdErr.HasUnscanned())
+      {
+      return static_cast<int>(i);
+      }
+    handles.push_back(p->Process);
+    }
+  if(handles.empty())
+    {
+    return -1;
+    }
+  return cmsysProcess_WaitForAny(&*handles.begin(),
+                                 static_cast<int>(handles.size()),
+                                 &timeout);
+}
+
 //----------------------------------------------------------------------------
 bool cmProcess::Buffer::GetLine(std::string& line)
 {
@@ -53,6 +53,13 @@ public:
    *   cmsysProcess_Pipe_Timeout = Timeout expired while waiting
    */
   int GetNextOutputLine(std::string& line, double timeout);
+  /**
+   * Block until GetNextOutputLine would not block for one of the
+   * given processes, but for no more than timeout.  Returns the index
+   * of that process, or -1 if the timeout expired first.
+   */
+  static int WaitForAny(std::vector<cmProcess*> const& processes,
+                        double timeout);
 private:
   double Timeout;
   double StartTime;
@@ -67,6 +74,7 @@ private:
     Buffer(): First(0), Last(0) {}
     bool GetLine(std::string& line);
     bool GetLast(std::string& line);
+    bool HasUnscanned() const { return this->Last != this->size(); }
   };
   Buffer StdErr;
   Buffer StdOut;
@@ -2187,6 +2187,20 @@ void cmCTest::HandleCommandLineArguments(size_t &i,
     this->GetHandler("test")->SetPersistentOption("RerunFailed", "true");
     this->GetHandler("memcheck")->SetPersistentOption("RerunFailed", "true");
     }
+
+  if(this->CheckArgument(arg, "--resource-pool") && i < args.size() - 1)
+    {
+    i++;
+    std::string pools = args[i];
+    if(const char* prev = this->GetHandler("test")->GetOption("ResourcePools"))
+      {
+      pools = std::string(prev) + ";" + pools;
+      }
+    this->GetHandler("test")->
+      SetPersistentOption("ResourcePools", pools.c_str());
+    this->GetHandler("memcheck")->
+      SetPersistentOption("ResourcePools", pools.c_str());
+    }
 }
 
 //----------------------------------------------------------------------
@@ -0,0 +1,376 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmComputeDirectoryHashes.h"
+
+#include "cmCacheManager.h"
+#include "cmComputeComponentGraph.h"
+#include "cmCryptoHash.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
+#include "cmSourceFile.h"
+#include "cmTarget.h"
+#include "cmVersion.h"
+#include "cmake.h"
+
+#include <algorithm>
+
+#include <ctype.h>
+
+/*
+
+The state written for a directory is everything the generators read
+from it: its variables, its properties and policy settings, and its
+targets and source files.  Cache entries are visible in every
+directory, so they are written once with the global state.  Each value is
+terminated by a character it cannot contain and each list is prefixed
+by its size, so distinct states never write the same text.
+
+A directory references another when the state of its targets and
+source files names a target of the other directory, for example in a
+link library, a utility dependency, or a generator expression.  The
+text is split into candidate names and each is looked up as the
+directory itself would look it up.  A name that happens to match a
+target only makes the hash depend on more state than needed.
+
+Directories may reference each other in cycles, so the hash of each
+strongly connected component of the reference graph is computed from
+the states of its directories and the hashes of the components it
+references.  Tarjan's algorithm numbers referenced components first.
+
+*/
+
+//----------------------------------------------------------------------------
+cmComputeDirectoryHashes::cmComputeDirectoryHashes(cmGlobalGenerator* gg):
+  GlobalGenerator(gg)
+{
+}
+
+//----------------------------------------------------------------------------
+cmComputeDirectoryHashes::~cmComputeDirectoryHashes()
+{
+}
+
+//----------------------------------------------------------------------------
+void cmComputeDirectoryHashes::Compute()
+{
+  std::vector<cmLocalGenerator*> const& lgs =
+    this->GlobalGenerator->GetLocalGenerators();
+  int n = static_cast<int>(lgs.size());
+  for(int i = 0; i < n; ++i)
+    {
+    this->DirectoryIndex[lgs[i]->GetMakefile()] = i;
+    }
+
+  cmCryptoHashMD5 md5;
+  this->StateHashes.resize(n);
+  this->References.resize(n);
+  for(int i = 0; i < n; ++i)
+    {
+    cmOStringStream state;
+    cmOStringStream targetsState;
+    this->WriteDirectoryState(lgs[i], state, targetsState);
+    std::string text = targetsState.str();
+    this->CollectReferences(i, text);
+    this->StateHashes[i] = md5.HashString(state.str() + text);
+    }
+
+  std::string globalHash;
+  {
+  cmOStringStream state;
+  this->WriteGlobalState(state);
+  globalHash = md5.HashString(state.str());
+  }
+
+  cmComputeComponentGraph ccg(this->References);
+  std::vector<cmGraphNodeList> const& components = ccg.GetComponents();
+  cmGraphAdjacencyList const& cgraph = ccg.GetComponentGraph();
+  std::vector<std::string> componentHashes(components.size());
+  for(size_t c = 0; c < components.size(); ++c)
+    {
+    std::vector<std::string> parts;
+    cmGraphNodeList const& nl = components[c];
+    for(cmGraphNodeList::const_iterator ni = nl.begin();
+        ni != nl.end(); ++ni)
+      {
+      parts.push_back(this->StateHashes[*ni]);
+      }
+    std::sort(parts.begin(), parts.end());
+    std::vector<std::string> referenced;
+    cmGraphEdgeList const& el = cgraph[c];
+    for(cmGraphEdgeList::const_iterator ei = el.begin();
+        ei != el.end(); ++ei)
+      {
+      referenced.push_back(componentHashes[*ei]);
+      }
+    std::sort(referenced.begin(), referenced.end());
+    referenced.erase(std::unique(referenced.begin(), referenced.end()),
+                     referenced.end());
+    parts.insert(parts.end(), referenced.begin(), referenced.end());
+    std::string text;
+    for(std::vector<std::string>::const_iterator pi = parts.begin();
+        pi != parts.end(); ++pi)
+      {
+      text += *pi;
+      }
+    componentHashes[c] = md5.HashString(text);
+    }
+
+  std::vector<int> const& cmap = ccg.GetComponentMap();
+  this->Hashes.resize(n);
+  for(int i = 0; i < n; ++i)
+    {
+    this->Hashes[i] = md5.HashString(globalHash + this->StateHashes[i] +
+                                     componentHashes[cmap[i]]);
+    }
+}
+
+//----------------------------------------------------------------------------
+std::string const&
+cmComputeDirectoryHashes::GetHash(cmLocalGenerator* lg) const
+{
+  std::map<cmMakefile const*, int>::const_iterator i =
+    this->DirectoryIndex.find(lg->GetMakefile());
+  return this->Hashes[i->second];
+}
+
+//----------------------------------------------------------------------------
+void cmComputeDirectoryHashes::WriteGlobalState(std::ostream& os)
+{
+  os << cmVersion::GetCMakeVersion() << '\0'
+     << this->GlobalGenerator->GetName() << '\0';
+  cmPropertyMap& props =
+    this->GlobalGenerator->GetCMakeInstance()->GetProperties();
+  os << props.size() << '\0';
+  for(cmPropertyMap::const_iterator i = props.begin(); i != props.end(); ++i)
+    {
+    const char* value = i->second.GetValue();
+    os << i->first << '\0' << (value? value : "") << '\0';
+    }
+
+  cmCacheManager::CacheIterator cit = this->GlobalGenerator
+    ->GetCMakeInstance()->GetCacheManager()->NewIterator();
+  for(cit.Begin(); !cit.IsAtEnd(); cit.Next())
+    {
+    os << cit.GetName() << '\0' << cit.GetValue() << '\0';
+    }
+  os << '\0';
+}
+
+//----------------------------------------------------------------------------
+static void cmWriteListState(std::ostream& os,
+                             std::vector<cmValueWithOrigin> const& entries)
+{
+  os << entries.size() << '\0';
+  for(std::vector<cmValueWithOrigin>::const_iterator i = entries.begin();
+      i != entries.end(); ++i)
+    {
+    os << i->Value << '\0';
+    }
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+static void cmWriteListState(std::ostream& os, T const& values)
+{
+  os << values.size() << '\0';
+  for(typename T::const_iterator i = values.begin(); i != values.end(); ++i)
+    {
+    os << *i << '\0';
+    }
+}
+
+//----------------------------------------------------------------------------
+static void cmWritePropertiesState(std::ostream& os,
+                                   cmPropertyMap const& props)
+{
+  os << props.size() << '\0';
+  for(cmPropertyMap::const_iterator i = props.begin(); i != props.end(); ++i)
+    {
+    const char* value = i->second.GetValue();
+    os << i->first << '\0' << (value? value : "") << '\0';
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmComputeDirectoryHashes::WriteDirectoryState(cmLocalGenerator* lg,
+                                                   std::ostream& os,
+                                                   std::ostream& targetsState)
+{
+  cmMakefile* mf = lg->GetMakefile();
+
+  // Paths in the build files are relative to directories of the tree.
+  for(cmLocalGenerator* p = lg; p; p = p->GetParent())
+    {
+    os << p->GetMakefile()->GetStartDirectory() << '\0'
+       << p->GetMakefile()->GetStartOutputDirectory() << '\0';
+    }
+  os << '\0';
+  std::vector<cmLocalGenerator*> const& children = lg->GetChildren();
+  os << children.size() << '\0';
+  for(std::vector<cmLocalGenerator*>::const_iterator ci = children.begin();
+      ci != children.end(); ++ci)
+    {
+    os << (*ci)->GetMakefile()->GetStartOutputDirectory() << '\0';
+    }
+
+  // Cache entries are written with the global state.
+  mf->WriteDefinitionsState(os);
+
+  for(int id = 0; id < cmPolicies::CMPCOUNT; ++id)
+    {
+    os << mf->GetPolicyStatus(static_cast<cmPolicies::PolicyID>(id)) << ' ';
+    }
+  os << '\0';
+
+  const char* includeRegex = mf->GetIncludeRegularExpression();
+  const char* complainRegex = mf->GetComplainRegularExpression();
+  os << (includeRegex? includeRegex : "") << '\0'
+     << (complainRegex? complainRegex : "") << '\0'
+     << mf->GetDefineFlags() << '\0';
+  cmWriteListState(os, mf->GetLinkDirectories());
+  cmWriteListState(os, mf->GetSystemIncludeDirectories());
+
+  // Directory properties may hold generator expressions naming
+  // targets, so they are written with the targets.
+  cmWritePropertiesState(targetsState, mf->GetProperties());
+  cmWriteListState(targetsState, mf->GetIncludeDirectoriesEntries());
+  cmWriteListState(targetsState, mf->GetCompileOptionsEntries());
+  cmWriteListState(targetsState, mf->GetCompileDefinitionsEntries());
+
+  // Sort the targets by name because they are stored in a hash map.
+  std::map<std::string, cmTarget const*> targets;
+  cmTargets const& tgts = mf->GetTargets();
+  for(cmTargets::const_iterator ti = tgts.begin(); ti != tgts.end(); ++ti)
+    {
+    targets[ti->first] = &ti->second;
+    }
+  targetsState << targets.size() << '\0';
+  for(std::map<std::string, cmTarget const*>::const_iterator
+        ti = targets.begin(); ti != targets.end(); ++ti)
+    {
+    ti->second->WriteState(targetsState);
+    }
+  std::vector<cmTarget*> const& imported = mf->GetOwnedImportedTargets();
+  targetsState << imported.size() << '\0';
+  for(std::vector<cmTarget*>::const_iterator ti = imported.begin();
+      ti != imported.end(); ++ti)
+    {
+    (*ti)->WriteState(targetsState);
+    }
+
+  std::vector<cmSourceFile*> const& sources = mf->GetSourceFiles();
+  targetsState << sources.size() << '\0';
+  for(std::vector<cmSourceFile*>::const_iterator si = sources.begin();
+      si != sources.end(); ++si)
+    {
+    cmSourceFile const* sf = *si;
+    cmSourceFileLocation const& location = sf->GetLocation();
+    targetsState << location.GetDirectory() << '\0'
+                 << location.GetName() << '\0'
+                 << sf->GetFullPath() << '\0'
+                 << sf->GetLanguage() << '\0'
+                 << sf->GetObjectLibrary() << '\0';
+    cmWritePropertiesState(targetsState, (*si)->GetProperties());
+    cmWriteListState(targetsState, sf->GetDepends());
+    if(cmCustomCommand const* cc = sf->GetCustomCommand())
+      {
+      targetsState << '1';
+      cc->WriteState(targetsState);
+      }
+    else
+      {
+      targetsState << '0';
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+static bool cmIsTargetNameChar(char c)
+{
+  return isalnum(static_cast<unsigned char>(c)) ||
+    c == '_' || c == '.' || c == '+' || c == '-';
+}
+
+//----------------------------------------------------------------------------
+void cmComputeDirectoryHashes::CollectReferences(int index,
+                                                 std::string const& text)
+{
+  std::set<std::string> names;
+  std::string::size_type n = text.size();
+  std::string::size_type i = 0;
+  while(i < n)
+    {
+    while(i < n && !cmIsTargetNameChar(text[i]))
+      {
+      ++i;
+      }
+    std::string::size_type j = i;
+    while(j < n && (cmIsTargetNameChar(text[j]) || text[j] == ':'))
+      {
+      ++j;
+      }
+    if(j == i)
+      {
+      break;
+      }
+
+    // A name may be namespaced with "::".  A single ':' separates
+    // the parts of generator expressions like "$<TARGET_FILE:tgt>".
+    std::string token = text.substr(i, j - i);
+    names.insert(token);
+    std::string::size_type start = 0;
+    for(std::string::size_type k = 0; k < token.size(); ++k)
+      {
+      if(token[k] != ':')
+        {
+        continue;
+        }
+      if(k + 1 < token.size() && token[k + 1] == ':')
+        {
+        ++k;
+        continue;
+        }
+      names.insert(token.substr(start, k - start));
+      start = k + 1;
+      }
+    if(start > 0)
+      {
+      names.insert(token.substr(start));
+      }
+    i = j;
+    }
+
+  cmMakefile* mf = this->GlobalGenerator->GetLocalGenerators()[index]
+                                        ->GetMakefile();
+  std::set<int> referenced;
+  for(std::set<std::string>::const_iterator ni = names.begin();
+      ni != names.end(); ++ni)
+    {
+    if(ni->empty())
+      {
+      continue;
+      }
+    cmTarget* t = mf->FindTargetToUse(*ni);
+    if(!t || t->GetType() == cmTarget::GLOBAL_TARGET)
+      {
+      continue;
+      }
+    std::map<cmMakefile const*, int>::const_iterator di =
+      this->DirectoryIndex.find(t->GetMakefile());
+    if(di != this->DirectoryIndex.end() && di->second != index &&
+       referenced.insert(di->second).second)
+      {
+      this->References[index].push_back(di->second);
+      }
+    }
+}
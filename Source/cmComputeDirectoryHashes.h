@@ -0,0 +1,62 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmComputeDirectoryHashes_h
+#define cmComputeDirectoryHashes_h
+
+#include "cmStandardIncludes.h"
+
+#include "cmGraphAdjacencyList.h"
+
+class cmGlobalGenerator;
+class cmLocalGenerator;
+class cmMakefile;
+
+/** \class cmComputeDirectoryHashes
+ * \brief Hash the state the build files of each directory depend on.
+ *
+ * The build files generated for a directory depend on the configured
+ * state of the directory and on the state of every directory whose
+ * targets it references, directly or through those directories.  This
+ * class computes a hash of that state for each directory so that a
+ * generator can keep the files of directories whose hash did not
+ * change since a previous run.
+ */
+class cmComputeDirectoryHashes
+{
+public:
+  cmComputeDirectoryHashes(cmGlobalGenerator* gg);
+  ~cmComputeDirectoryHashes();
+
+  void Compute();
+
+  /** Get the hash computed for the directory of a local generator.  */
+  std::string const& GetHash(cmLocalGenerator* lg) const;
+private:
+  void WriteGlobalState(std::ostream& os);
+  void WriteDirectoryState(cmLocalGenerator* lg, std::ostream& os,
+                           std::ostream& targetsState);
+  void CollectReferences(int index, std::string const& text);
+
+  cmGlobalGenerator* GlobalGenerator;
+  std::map<cmMakefile const*, int> DirectoryIndex;
+
+  // The hash of the state of each directory itself.
+  std::vector<std::string> StateHashes;
+
+  // The directories whose targets each directory references.
+  cmGraphAdjacencyList References;
+
+  // The hash of everything the build files of each directory depend on.
+  std::vector<std::string> Hashes;
+};
+
+#endif
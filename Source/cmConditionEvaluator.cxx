@@ -556,8 +556,10 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList &newArgs,
         def = this->GetVariableOrString(*arg);
         const char* rex = argP2->c_str();
         this->Makefile.ClearMatches();
-        cmsys::RegularExpression regEntry;
-        if ( !regEntry.compile(rex) )
+        cmsys::RegularExpression* regEntry =
+          this->Makefile.GetCMakeInstance()->GetRegularExpressionCache()
+          ->Get(rex);
+        if ( !regEntry )
           {
           cmOStringStream error;
           error << "Regular expression \"" << rex << "\" cannot compile";
@@ -565,9 +567,9 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList &newArgs,
           status = cmake::FATAL_ERROR;
           return false;
           }
-        if (regEntry.find(def))
+        if (regEntry->find(def))
           {
-          this->Makefile.StoreMatches(regEntry);
+          this->Makefile.StoreMatches(*regEntry);
           *arg = cmExpandedCommandArgument("1", true);
           }
         else
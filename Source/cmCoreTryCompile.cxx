@@ -15,11 +15,18 @@
 #include "cmLocalGenerator.h"
 #include "cmGlobalGenerator.h"
 #include "cmExportTryCompileFileGenerator.h"
+#include "cmGeneratedFileStream.h"
+#include "cmVersion.h"
 #include <cmsys/Directory.hxx>
+#include <cmsys/FStream.hxx>
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include "cmCryptoHash.h"
+#endif
 
 #include <assert.h>
 
-int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
+int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
+                                     bool isTryRun)
 {
   this->BinaryDirectory = argv[1].c_str();
   this->OutputFile = "";
@@ -43,6 +50,7 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
   bool didCopyFileError = false;
   bool useSources = argv[2] == "SOURCES";
   std::vector<std::string> sources;
+  std::string resultCacheFile;
 
   enum Doing { DoingNone, DoingCMakeFlags, DoingCompileDefinitions,
                DoingLinkLibraries, DoingOutputVariable, DoingCopyFile,
@@ -477,22 +485,67 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
       }
     fclose(fout);
     projectName = "CMAKE_TRY_COMPILE";
+
+    // The result can be reused only when nothing but the result and
+    // output is needed afterwards.
+    if(!isTryRun && copyFile.empty() && targets.empty() &&
+       !this->Makefile->GetCMakeInstance()->GetDebugTryCompile())
+      {
+      resultCacheFile = this->GetResultCacheFile(outFileName, targetName,
+                                                 testLangs, sources,
+                                                 cmakeFlags);
+      }
     }
 
-  bool erroroc = cmSystemTools::GetErrorOccuredFlag();
-  cmSystemTools::ResetErrorOccuredFlag();
   std::string output;
-  // actually do the try compile now that everything is setup
-  int res = this->Makefile->TryCompile(sourceDirectory,
-                                       this->BinaryDirectory,
-                                       projectName,
-                                       targetName,
-                                       this->SrcFileSignature,
-                                       &cmakeFlags,
-                                       output);
-  if ( erroroc )
+  int res = 0;
+  bool cached = false;
+  if(!resultCacheFile.empty())
+    {
+    // The first line holds the result and the rest the build output.
+    cmsys::ifstream fin(resultCacheFile.c_str());
+    std::string line;
+    char* end = 0;
+    long value = 0;
+    if(fin && cmSystemTools::GetLineFromStream(fin, line) &&
+       !line.empty())
+      {
+      value = strtol(line.c_str(), &end, 10);
+      }
+    // A record without a valid result is treated as a miss.
+    if(end && end != line.c_str() && *end == 0)
+      {
+      res = static_cast<int>(value);
+      cmOStringStream rest;
+      rest << fin.rdbuf();
+      output = rest.str();
+      cached = true;
+      }
+    }
+
+  if(!cached)
     {
-    cmSystemTools::SetErrorOccured();
+    bool erroroc = cmSystemTools::GetErrorOccuredFlag();
+    cmSystemTools::ResetErrorOccuredFlag();
+    // actually do the try compile now that everything is setup
+    res = this->Makefile->TryCompile(sourceDirectory,
+                                     this->BinaryDirectory,
+                                     projectName,
+                                     targetName,
+                                     this->SrcFileSignature,
+                                     &cmakeFlags,
+                                     output);
+
+    // Do not keep a result that CMake itself failed to produce.
+    if(!resultCacheFile.empty() && !cmSystemTools::GetErrorOccuredFlag())
+      {
+      cmGeneratedFileStream fout(resultCacheFile.c_str());
+      fout << res << "\n" << output;
+      }
+    if ( erroroc )
+      {
+      cmSystemTools::SetErrorOccured();
+      }
     }
 
   // set the result var to the return value to indicate success or failure
@@ -547,6 +600,134 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv)
   return res;
 }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+static bool cmCoreTryCompileReadFile(std::string const& file,
+                                     std::string& content)
+{
+  cmsys::ifstream fin(file.c_str(), std::ios::in | std::ios::binary);
+  if(!fin)
+    {
+    return false;
+    }
+  cmOStringStream os;
+  os << fin.rdbuf();
+  content = os.str();
+  return true;
+}
+#endif
+
+std::string
+cmCoreTryCompile::GetResultCacheFile(std::string const& listFile,
+                                     std::string const& targetName,
+                                     std::set<std::string> const& langs,
+                                     std::vector<std::string> const& sources,
+                                     std::vector<std::string> const& flags)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  const char* cacheDir =
+    this->Makefile->GetDefinition("CMAKE_TRY_COMPILE_CACHE_DIR");
+  if(!cacheDir || !*cacheDir)
+    {
+    return "";
+    }
+
+  // Collect everything that affects the result into one string.  The
+  // generated project names a random target and the binary directory, so
+  // take those out to share results between runs and build trees.
+  std::string key = "cmake ";
+  key += cmVersion::GetCMakeVersion();
+  key += "\ngenerator ";
+  key += this->Makefile->GetLocalGenerator()->GetGlobalGenerator()->GetName();
+  key += "\nplatform ";
+  key += this->Makefile->GetCMakeInstance()->GetGeneratorPlatform();
+  key += "\ntoolset ";
+  key += this->Makefile->GetCMakeInstance()->GetGeneratorToolset();
+  key += "\nconfig ";
+  key += this->Makefile->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
+  key += "\nLDFLAGS ";
+  if(const char* ldflags = cmSystemTools::GetEnv("LDFLAGS"))
+    {
+    key += ldflags;
+    }
+  key += "\n";
+
+  // The compiler information files identify the compiler and its ABI.
+  std::string infoDir =
+    this->Makefile->GetSafeDefinition("CMAKE_PLATFORM_INFO_DIR");
+  for(std::set<std::string>::const_iterator li = langs.begin();
+      li != langs.end(); ++li)
+    {
+    std::string info = infoDir + "/CMake" + *li + "Compiler.cmake";
+    std::string content;
+    if(!cmCoreTryCompileReadFile(info, content))
+      {
+      // The compiler is still being determined.
+      return "";
+      }
+    key += "compiler " + *li + "\n" + content + "\n";
+
+    // The project includes the rules override file, so its content
+    // matters as much as its path.
+    std::string rulesOverride = "CMAKE_USER_MAKE_RULES_OVERRIDE";
+    const char* rulesFile =
+      this->Makefile->GetDefinition(rulesOverride + "_" + *li);
+    if(!rulesFile)
+      {
+      rulesFile = this->Makefile->GetDefinition(rulesOverride);
+      }
+    if(rulesFile && *rulesFile)
+      {
+      if(!cmCoreTryCompileReadFile(rulesFile, content))
+        {
+        return "";
+        }
+      key += "rules " + *li + "\n" + content + "\n";
+      }
+    }
+
+  std::string project;
+  if(!cmCoreTryCompileReadFile(listFile, project))
+    {
+    return "";
+    }
+  cmSystemTools::ReplaceString(project, targetName.c_str(),
+                               "<TARGET>");
+  cmSystemTools::ReplaceString(project, this->BinaryDirectory.c_str(),
+                               "<BINARY_DIR>");
+  key += "project\n" + project + "\n";
+
+  for(std::vector<std::string>::const_iterator fi = flags.begin();
+      fi != flags.end(); ++fi)
+    {
+    key += "flag " + *fi + "\n";
+    }
+
+  for(std::vector<std::string>::const_iterator si = sources.begin();
+      si != sources.end(); ++si)
+    {
+    std::string content;
+    if(!cmCoreTryCompileReadFile(*si, content))
+      {
+      return "";
+      }
+    key += "source " + cmSystemTools::GetFilenameLastExtension(*si) + "\n";
+    key += content + "\n";
+    }
+
+  cmsys::auto_ptr<cmCryptoHash> md5 = cmCryptoHash::New("MD5");
+  std::string dir = cacheDir;
+  cmSystemTools::MakeDirectory(dir.c_str());
+  return dir + "/" + md5->HashString(key) + ".txt";
+#else
+  (void)listFile;
+  (void)targetName;
+  (void)langs;
+  (void)sources;
+  (void)flags;
+  return "";
+#endif
+}
+
 void cmCoreTryCompile::CleanupFiles(const char* binDir)
 {
   if ( !binDir )
@@ -28,9 +28,22 @@ public:
   /**
    * This is the core code for try compile. It is here so that other
    * commands, such as TryRun can access the same logic without
-   * duplication.
+   * duplication.  The result of a source file signature may be taken
+   * from CMAKE_TRY_COMPILE_CACHE_DIR unless isTryRun is set, because
+   * TryRun needs the executable.
    */
-  int TryCompileCode(std::vector<std::string> const& argv);
+  int TryCompileCode(std::vector<std::string> const& argv, bool isTryRun);
+
+  /**
+   * Compute the file that caches the result of a source file signature
+   * from everything that can affect it, or return an empty string if
+   * the result cache is not enabled.
+   */
+  std::string GetResultCacheFile(std::string const& listFile,
+                                 std::string const& targetName,
+                                 std::set<std::string> const& langs,
+                                 std::vector<std::string> const& sources,
+                                 std::vector<std::string> const& cmakeFlags);
 
   /**
    * This deletes all the files created by TryCompileCode.
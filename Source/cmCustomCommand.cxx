@@ -184,3 +184,43 @@ void cmCustomCommand::AppendImplicitDepends(ImplicitDependsList const& l)
   this->ImplicitDepends.insert(this->ImplicitDepends.end(),
                                l.begin(), l.end());
 }
+
+//----------------------------------------------------------------------------
+void cmCustomCommand::WriteState(std::ostream& os) const
+{
+  // Terminate each value with a character it cannot contain and
+  // prefix each list with its size so that distinct commands never
+  // write the same text.
+  os << this->Outputs.size() << '\0';
+  for(std::vector<std::string>::const_iterator i = this->Outputs.begin();
+      i != this->Outputs.end(); ++i)
+    {
+    os << *i << '\0';
+    }
+  os << this->Depends.size() << '\0';
+  for(std::vector<std::string>::const_iterator i = this->Depends.begin();
+      i != this->Depends.end(); ++i)
+    {
+    os << *i << '\0';
+    }
+  os << this->CommandLines.size() << '\0';
+  for(cmCustomCommandLines::const_iterator cl = this->CommandLines.begin();
+      cl != this->CommandLines.end(); ++cl)
+    {
+    os << cl->size() << '\0';
+    for(cmCustomCommandLine::const_iterator i = cl->begin();
+        i != cl->end(); ++i)
+      {
+      os << *i << '\0';
+      }
+    }
+  os << this->HaveComment << this->Comment << '\0'
+     << this->WorkingDirectory << '\0'
+     << this->EscapeAllowMakeVars << this->EscapeOldStyle << '\0';
+  os << this->ImplicitDepends.size() << '\0';
+  for(ImplicitDependsList::const_iterator i = this->ImplicitDepends.begin();
+      i != this->ImplicitDepends.end(); ++i)
+    {
+    os << i->first << '\0' << i->second << '\0';
+    }
+}
@@ -79,6 +79,10 @@ public:
   void AppendImplicitDepends(ImplicitDependsList const&);
   ImplicitDependsList const& GetImplicitDepends() const;
 
+  /** Write everything generators read from this command to a stream
+      so that callers can tell whether it changed.  */
+  void WriteState(std::ostream& os) const;
+
 private:
   std::vector<std::string> Outputs;
   std::vector<std::string> Depends;
@@ -11,6 +11,8 @@
 ============================================================================*/
 #include "cmDefinitions.h"
 
+#include <algorithm>
+
 //----------------------------------------------------------------------------
 cmDefinitions::Def cmDefinitions::NoDef;
 
@@ -39,7 +41,18 @@ cmDefinitions::GetInternal(const std::string& key) const
   if(cmDefinitions* up = this->Up)
     {
     // Query the parent scope.
-    return up->GetInternal(key);
+    Def const& def = up->GetInternal(key);
+    if(!def.Exists)
+      {
+      return def;
+      }
+
+    // Save the result locally so that the next lookup of this key
+    // does not have to search the parent scopes again.  Parent scopes
+    // change only by set(PARENT_SCOPE), which first localizes the key.
+    Def& local = this->Map[key] = def;
+    local.Cached = true;
+    return local;
     }
   return this->NoDef;
 }
@@ -51,7 +64,9 @@ cmDefinitions::SetInternal(const std::string& key, Def const& def)
   if(this->Up || def.Exists)
     {
     // In lower scopes we store keys, defined or not.
-    return (this->Map[key] = def);
+    Def& local = this->Map[key] = def;
+    local.Cached = false;
+    return local;
     }
   else
     {
@@ -96,7 +111,7 @@ std::set<std::string> cmDefinitions::LocalKeys() const
   for(MapType::const_iterator mi = this->Map.begin();
       mi != this->Map.end(); ++mi)
     {
-    if (mi->second.Exists)
+    if (mi->second.Exists && !mi->second.Cached)
       {
       keys.insert(mi->first);
       }
@@ -132,7 +147,8 @@ void cmDefinitions::ClosureImpl(std::set<std::string>& undefined,
       {
       if(mi->second.Exists)
         {
-        this->Map.insert(*mi);
+        Def& def = this->Map[mi->first] = mi->second;
+        def.Cached = false;
         }
       else
         {
@@ -180,3 +196,39 @@ void cmDefinitions::ClosureKeys(std::set<std::string>& defined,
     up->ClosureKeys(defined, undefined);
     }
 }
+
+//----------------------------------------------------------------------------
+struct cmDefinitions::KeyLess
+{
+  bool operator()(MapType::const_iterator l, MapType::const_iterator r) const
+    {
+    return l->first < r->first;
+    }
+};
+
+//----------------------------------------------------------------------------
+void cmDefinitions::WriteState(std::ostream& os) const
+{
+  if(this->Up)
+    {
+    this->Closure().WriteState(os);
+    return;
+    }
+
+  std::vector<MapType::const_iterator> defs;
+  for(MapType::const_iterator mi = this->Map.begin();
+      mi != this->Map.end(); ++mi)
+    {
+    if(mi->second.Exists)
+      {
+      defs.push_back(mi);
+      }
+    }
+  std::sort(defs.begin(), defs.end(), KeyLess());
+  os << defs.size() << '\0';
+  for(std::vector<MapType::const_iterator>::const_iterator di = defs.begin();
+      di != defs.end(); ++di)
+    {
+    os << (*di)->first << '\0' << (*di)->second << '\0';
+    }
+}
@@ -55,6 +55,10 @@ public:
   /** Compute the set of all defined keys.  */
   std::set<std::string> ClosureKeys() const;
 
+  /** Write all defined keys and their values to a stream in a stable
+      order so that callers can tell whether any changed.  */
+  void WriteState(std::ostream& os) const;
+
 private:
   // String with existence boolean.
   struct Def: public std::string
@@ -62,24 +66,28 @@ private:
   private:
     typedef std::string std_string;
   public:
-    Def(): std_string(), Exists(false) {}
-    Def(const char* v): std_string(v?v:""), Exists(v?true:false) {}
-    Def(const std_string& v): std_string(v), Exists(true) {}
-    Def(Def const& d): std_string(d), Exists(d.Exists) {}
+    Def(): std_string(), Exists(false), Cached(false) {}
+    Def(const char* v): std_string(v?v:""), Exists(v?true:false),
+                        Cached(false) {}
+    Def(const std_string& v): std_string(v), Exists(true), Cached(false) {}
+    Def(Def const& d): std_string(d), Exists(d.Exists), Cached(d.Cached) {}
     bool Exists;
+    // Whether this is a copy of a definition found in a parent scope.
+    bool Cached;
   };
   static Def NoDef;
 
   // Parent scope, if any.
   cmDefinitions* Up;
 
-  // Local definitions, set or unset.
+  // Local definitions, set or unset, and definitions from parent
+  // scopes cached by lookups.
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   typedef cmsys::hash_map<std::string, Def> MapType;
 #else
   typedef std::map<std::string, Def> MapType;
 #endif
-  MapType Map;
+  mutable MapType Map;
 
   // Internal query and update methods.
   Def const& GetInternal(const std::string& key) const;
@@ -91,6 +99,9 @@ private:
   void ClosureImpl(std::set<std::string>& undefined,
                    cmDefinitions const* defs);
 
+  // Order definitions by key in WriteState.
+  struct KeyLess;
+
   // Implementation of ClosureKeys() method.
   void ClosureKeys(std::set<std::string>& defined,
                    std::set<std::string>& undefined) const;
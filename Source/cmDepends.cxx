@@ -205,7 +205,7 @@ bool cmDepends::CheckDependencies(std::istream& internalDepends,
       currentDependencies->push_back(dependee);
       }
 
-    if(!cmSystemTools::FileExists(dependee))
+    if(!this->FileComparison->FileExists(dependee))
       {
       // The dependee does not exist.
       regenerate = true;
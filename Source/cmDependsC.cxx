@@ -12,9 +12,11 @@
 #include "cmDependsC.h"
 
 #include "cmFileTimeComparison.h"
+#include "cmGlobalGenerator.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
 #include <cmsys/FStream.hxx>
 
 #include <ctype.h> // isspace
@@ -28,9 +30,78 @@
 #define INCLUDE_REGEX_COMPLAIN_MARKER "#IncludeRegexComplain: "
 #define INCLUDE_REGEX_TRANSFORM_MARKER "#IncludeRegexTransform: "
 
+//----------------------------------------------------------------------------
+// Skip the leading "#include" or "#import" of a line the way the start
+// of INCLUDE_REGEX_LINE matches it.  Returns the position just after
+// the directive name, or 0 if the line does not start with one.
+static const char* cmDependsCSkipDirective(const char* c)
+{
+  while(*c == ' ' || *c == '\t')
+    {
+    ++c;
+    }
+  if(*c != '#')
+    {
+    return 0;
+    }
+  ++c;
+  while(*c == ' ' || *c == '\t')
+    {
+    ++c;
+    }
+  if(strncmp(c, "include", 7) == 0)
+    {
+    return c + 7;
+    }
+  if(strncmp(c, "import", 6) == 0)
+    {
+    return c + 6;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+// Match a line exactly as INCLUDE_REGEX_LINE would.  Scanning a line by
+// hand is much cheaper than running the regular expression on every
+// line of every file.  On a match, store the included name and whether
+// it was terminated by a double quote.
+static bool cmDependsCMatchInclude(const char* line, std::string& name,
+                                   bool& quoted)
+{
+  const char* c = cmDependsCSkipDirective(line);
+  if(!c)
+    {
+    return false;
+    }
+  while(*c == ' ' || *c == '\t')
+    {
+    ++c;
+    }
+  if(*c != '<' && *c != '"')
+    {
+    return false;
+    }
+  const char* begin = ++c;
+  while(*c && *c != '"' && *c != '>')
+    {
+    ++c;
+    }
+  if(c == begin || !*c)
+    {
+    return false;
+    }
+  name.assign(begin, c - begin);
+  quoted = *c == '"';
+  return true;
+}
+
 //----------------------------------------------------------------------------
 cmDependsC::cmDependsC()
 : ValidDeps(0)
+, SharedCacheLoaded(false)
+, SharedCacheValid(false)
+, SharedCacheRecords(0)
+, ScanStartTime(0)
 {
 }
 
@@ -41,6 +112,10 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
                    const std::map<std::string, DependencyVector>* validDeps)
 : cmDepends(lg, targetDir)
 , ValidDeps(validDeps)
+, SharedCacheLoaded(false)
+, SharedCacheValid(false)
+, SharedCacheRecords(0)
+, ScanStartTime(static_cast<long>(time(0)))
 {
   cmMakefile* mf = lg->GetMakefile();
 
@@ -67,7 +142,6 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
     }
   }
 
-  this->IncludeRegexLine.compile(INCLUDE_REGEX_LINE);
   this->IncludeRegexScan.compile(scanRegex.c_str());
   this->IncludeRegexComplain.compile(complainRegex.c_str());
   this->IncludeRegexLineString = INCLUDE_REGEX_LINE_MARKER INCLUDE_REGEX_LINE;
@@ -83,13 +157,38 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
   this->CacheFileName += lang;
   this->CacheFileName += ".includecache";
 
+  // Check the cache entries against the file times known to this run.
+  this->FileComparison =
+    lg->GetGlobalGenerator()->GetCMakeInstance()->GetFileComparison();
   this->ReadCacheFile();
+
+  // The include lines found in a header depend on the scanning rules,
+  // so keep one build tree cache per set of rules.
+  std::string homeOutDir = mf->GetHomeOutputDirectory();
+  if(!homeOutDir.empty())
+    {
+    std::string rules = this->IncludeRegexLineString + "\n";
+    rules += this->IncludeRegexScanString + "\n";
+    rules += this->IncludeRegexComplainString + "\n";
+    rules += this->IncludeRegexTransformString;
+    this->SharedCacheFileName = homeOutDir;
+    this->SharedCacheFileName += cmake::GetCMakeFilesDirectory();
+    this->SharedCacheFileName += "/";
+    this->SharedCacheFileName += lang;
+    this->SharedCacheFileName += "-";
+    this->SharedCacheFileName += cmSystemTools::ComputeStringMD5(rules);
+    this->SharedCacheFileName += ".includecache";
+    }
 }
 
 //----------------------------------------------------------------------------
 cmDependsC::~cmDependsC()
 {
   this->WriteCacheFile();
+  if(!this->SharedCacheAdditions.empty())
+    {
+    this->WriteSharedCacheFile();
+    }
 
   for (std::map<std::string, cmIncludeLines*>::iterator it=
          this->FileCache.begin(); it!=this->FileCache.end(); ++it)
@@ -161,6 +260,7 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
       // Get the next file to scan.
       UnscannedEntry current = this->Unscanned.front();
       this->Unscanned.pop();
+      bool isSource = srcFiles > 0;
 
       // If not a full path, find the file in the include path.
       std::string fullName;
@@ -226,6 +326,11 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
         // Check whether this file is already in the cache
         std::map<std::string, cmIncludeLines*>::iterator fileIt=
           this->FileCache.find(fullName);
+        if (fileIt==this->FileCache.end() && !isSource &&
+            this->FindInSharedCache(fullName))
+          {
+          fileIt=this->FileCache.find(fullName);
+          }
         if (fileIt!=this->FileCache.end())
           {
           fileIt->second->Used=true;
@@ -245,6 +350,14 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
         else
           {
 
+          long mtime = 0;
+          long mtimeNS = 0;
+          if(!isSource && !this->SharedCacheFileName.empty())
+            {
+            this->FileComparison->FileTime(fullName.c_str(),
+                                           &mtime, &mtimeNS);
+            }
+
           // Try to scan the file.  Just leave it out if we cannot find
           // it.
           cmsys::ifstream fin(fullName.c_str());
@@ -257,6 +370,19 @@ bool cmDependsC::WriteDependencies(const std::set<std::string>& sources,
             // containing the file to handle double-quote includes.
             std::string dir = cmSystemTools::GetFilenamePath(fullName);
             this->Scan(fin, dir.c_str(), fullName);
+
+            // Share the include lines of the header with other targets.
+            // A header modified in the second we started may change
+            // again without a new modification time, so skip it.
+            if(mtime != 0 && mtime < this->ScanStartTime)
+              {
+              SharedIncludeLines& shared =
+                this->SharedCacheAdditions[fullName];
+              shared.ModifiedTime = mtime;
+              shared.ModifiedTimeNS = mtimeNS;
+              shared.UnscannedEntries =
+                this->FileCache[fullName]->UnscannedEntries;
+              }
             }
           }
         }
@@ -321,9 +447,8 @@ void cmDependsC::ReadCacheFile()
       {
       haveFileName=true;
       int newer=0;
-      cmFileTimeComparison comp;
-      bool res=comp.FileTimeCompare(this->CacheFileName.c_str(),
-                                    line.c_str(), &newer);
+      bool res=this->FileComparison->FileTimeCompare(
+        this->CacheFileName.c_str(), line.c_str(), &newer);
 
       if ((res==true) && (newer==1)) //cache is newer than the parsed file
         {
@@ -425,6 +550,242 @@ void cmDependsC::WriteCacheFile() const
    }
 }
 
+//----------------------------------------------------------------------------
+bool cmDependsC::FindInSharedCache(std::string const& fullName)
+{
+  if(this->SharedCacheFileName.empty())
+    {
+    return false;
+    }
+  if(!this->SharedCacheLoaded)
+    {
+    this->SharedCacheLoaded = true;
+    this->SharedCacheValid =
+      this->ReadSharedCacheFile(this->SharedCache, this->SharedCacheRecords);
+    }
+  SharedCacheType::const_iterator i = this->SharedCache.find(fullName);
+  if(i == this->SharedCache.end() ||
+     !this->SharedRecordIsCurrent(fullName, i->second))
+    {
+    return false;
+    }
+  cmIncludeLines* cacheEntry = new cmIncludeLines;
+  cacheEntry->UnscannedEntries = i->second.UnscannedEntries;
+  this->FileCache[fullName] = cacheEntry;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsC::SharedRecordIsCurrent(std::string const& fileName,
+                                       SharedIncludeLines const& shared) const
+{
+  long mtime;
+  long mtimeNS;
+  return (this->FileComparison->FileTime(fileName.c_str(),
+                                         &mtime, &mtimeNS) &&
+          mtime == shared.ModifiedTime && mtimeNS == shared.ModifiedTimeNS);
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsC::ReadSharedCacheFile(SharedCacheType& cache,
+                                     size_t& records) const
+{
+  records = 0;
+  cmsys::ifstream fin(this->SharedCacheFileName.c_str());
+  if(!fin)
+    {
+    return false;
+    }
+
+  // The file starts with the scanning rules it was written for.
+  cmOStringStream header;
+  this->WriteSharedCacheHeader(header);
+  std::vector<std::string> headerLines;
+  cmSystemTools::Split(header.str().c_str(), headerLines);
+  std::string line;
+  for(std::vector<std::string>::const_iterator hi = headerLines.begin();
+      hi != headerLines.end(); ++hi)
+    {
+    if(!cmSystemTools::GetLineFromStream(fin, line) || line != *hi)
+      {
+      return false;
+      }
+    }
+
+  // Each record is the header name, its modification time and number
+  // of include entries, the entries, and an empty line.  A record
+  // another scanner is still appending is incomplete; skip it.
+  std::string fileName;
+  while(cmSystemTools::GetLineFromStream(fin, fileName))
+    {
+    if(fileName.empty() || !cmSystemTools::GetLineFromStream(fin, line))
+      {
+      continue;
+      }
+    SharedIncludeLines shared;
+    unsigned long count = 0;
+    if(sscanf(line.c_str(), "%ld %ld %lu", &shared.ModifiedTime,
+              &shared.ModifiedTimeNS, &count) != 3)
+      {
+      continue;
+      }
+    UnscannedEntry entry;
+    while(shared.UnscannedEntries.size() < count &&
+          cmSystemTools::GetLineFromStream(fin, entry.FileName) &&
+          !entry.FileName.empty() &&
+          cmSystemTools::GetLineFromStream(fin, line))
+      {
+      entry.QuotedLocation = line == "-"? std::string() : line;
+      shared.UnscannedEntries.push_back(entry);
+      }
+    bool newline = false;
+    if(shared.UnscannedEntries.size() == count &&
+       cmSystemTools::GetLineFromStream(fin, line, &newline) &&
+       line.empty() && newline)
+      {
+      cache[fileName] = shared;
+      ++records;
+      }
+    else
+      {
+      // Continue after the end of the damaged record.
+      while(!line.empty() && cmSystemTools::GetLineFromStream(fin, line))
+        {
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmDependsC::WriteSharedCacheHeader(std::ostream& os) const
+{
+  os << "# CMake shared include cache, version 3\n";
+  os << this->IncludeRegexLineString << "\n";
+  os << this->IncludeRegexScanString << "\n";
+  os << this->IncludeRegexComplainString << "\n";
+  os << this->IncludeRegexTransformString << "\n";
+}
+
+//----------------------------------------------------------------------------
+void cmDependsC::WriteSharedCacheRecord(std::ostream& os,
+                                        std::string const& fileName,
+                                        SharedIncludeLines const& shared)
+{
+  os << fileName << "\n" << shared.ModifiedTime << " "
+     << shared.ModifiedTimeNS << " "
+     << shared.UnscannedEntries.size() << "\n";
+  for(std::vector<UnscannedEntry>::const_iterator
+        incIt = shared.UnscannedEntries.begin();
+      incIt != shared.UnscannedEntries.end(); ++incIt)
+    {
+    os << incIt->FileName << "\n";
+    if(incIt->QuotedLocation.empty())
+      {
+      os << "-\n";
+      }
+    else
+      {
+      os << incIt->QuotedLocation << "\n";
+      }
+    }
+  os << "\n";
+}
+
+//----------------------------------------------------------------------------
+void cmDependsC::WriteSharedCacheFile() const
+{
+  // Append the new records, unless the file has yet to be written or
+  // most of the records read from it have been replaced since.
+  bool compact = !cmSystemTools::FileExists(this->SharedCacheFileName.c_str());
+  if(this->SharedCacheLoaded)
+    {
+    compact = compact || !this->SharedCacheValid ||
+      (this->SharedCacheRecords > 64 &&
+       this->SharedCacheRecords > 2 * this->SharedCache.size());
+    }
+  if(compact)
+    {
+    this->CompactSharedCacheFile();
+    }
+  else
+    {
+    this->AppendSharedCacheFile();
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmDependsC::AppendSharedCacheFile() const
+{
+  cmOStringStream records;
+  for(SharedCacheType::const_iterator i = this->SharedCacheAdditions.begin();
+      i != this->SharedCacheAdditions.end(); ++i)
+    {
+    WriteSharedCacheRecord(records, i->first, i->second);
+    }
+
+  // Append all records with a single unbuffered write so that records
+  // appended by scanners running in parallel do not interleave.
+  std::string data = records.str();
+  FILE* fout = cmsys::SystemTools::Fopen(this->SharedCacheFileName, "ab");
+  if(!fout)
+    {
+    return;
+    }
+  setvbuf(fout, 0, _IONBF, 0);
+  fwrite(data.c_str(), 1, data.size(), fout);
+  fclose(fout);
+}
+
+//----------------------------------------------------------------------------
+void cmDependsC::CompactSharedCacheFile() const
+{
+  // Merge the records in the file now with ours, drop those of headers
+  // that were removed or changed, and write the result under a unique
+  // name that is renamed into place, so that parallel scanners never see
+  // a partial file.  A record appended to the old file meanwhile is
+  // lost, which only costs a rescan.
+  SharedCacheType cache;
+  size_t records;
+  this->ReadSharedCacheFile(cache, records);
+  for(SharedCacheType::const_iterator i = this->SharedCacheAdditions.begin();
+      i != this->SharedCacheAdditions.end(); ++i)
+    {
+    cache[i->first] = i->second;
+    }
+
+  char suffix[64];
+  sprintf(suffix, ".tmp%u", cmSystemTools::RandomSeed());
+  std::string tmpName = this->SharedCacheFileName + suffix;
+  {
+  cmsys::ofstream cacheOut(tmpName.c_str());
+  if(!cacheOut)
+    {
+    return;
+    }
+  this->WriteSharedCacheHeader(cacheOut);
+  for(SharedCacheType::const_iterator i = cache.begin();
+      i != cache.end(); ++i)
+    {
+    if(this->SharedRecordIsCurrent(i->first, i->second))
+      {
+      WriteSharedCacheRecord(cacheOut, i->first, i->second);
+      }
+    }
+  cacheOut.close();
+  if(!cacheOut)
+    {
+    cmSystemTools::RemoveFile(tmpName);
+    return;
+    }
+  }
+  if(!cmSystemTools::RenameFile(tmpName.c_str(),
+                                this->SharedCacheFileName.c_str()))
+    {
+    cmSystemTools::RemoveFile(tmpName);
+    }
+}
+
 //----------------------------------------------------------------------------
 void cmDependsC::Scan(std::istream& is, const char* directory,
   const std::string& fullName)
@@ -437,6 +798,13 @@ void cmDependsC::Scan(std::istream& is, const char* directory,
   std::string line;
   while(cmSystemTools::GetLineFromStream(is, line))
     {
+    // Only preprocessor include directives are of interest, and the
+    // transform rules apply to nothing else.
+    if(!cmDependsCSkipDirective(line.c_str()))
+      {
+      continue;
+      }
+
     // Transform the line content first.
     if(!this->TransformRules.empty())
       {
@@ -444,13 +812,13 @@ void cmDependsC::Scan(std::istream& is, const char* directory,
       }
 
     // Match include directives.
-    if(this->IncludeRegexLine.find(line.c_str()))
+    UnscannedEntry entry;
+    bool quoted;
+    if(cmDependsCMatchInclude(line.c_str(), entry.FileName, quoted))
       {
       // Get the file being included.
-      UnscannedEntry entry;
-      entry.FileName = this->IncludeRegexLine.match(2);
       cmSystemTools::ConvertToUnixSlashes(entry.FileName);
-      if(this->IncludeRegexLine.match(3) == "\"" &&
+      if(quoted &&
          !cmSystemTools::FileIsFullPath(entry.FileName.c_str()))
         {
         // This was a double-quoted include with a relative path.  We
@@ -43,9 +43,6 @@ protected:
   void Scan(std::istream& is, const char* directory,
     const std::string& fullName);
 
-  // Regular expression to identify C preprocessor include directives.
-  cmsys::RegularExpression IncludeRegexLine;
-
   // Regular expressions to choose which include files to scan
   // recursively and which to complain about not finding.
   cmsys::RegularExpression IncludeRegexScan;
@@ -89,6 +86,40 @@ protected:
 
   void WriteCacheFile() const;
   void ReadCacheFile();
+
+  // Include lines of headers recorded for the whole build tree so that
+  // a header used by many targets is scanned only once.  Records are
+  // valid while the modification time of the header is unchanged.  New
+  // records are appended to the file, and a later record for the same
+  // header replaces an earlier one.
+  struct SharedIncludeLines
+  {
+    SharedIncludeLines(): ModifiedTime(0), ModifiedTimeNS(0) {}
+    long ModifiedTime;
+    long ModifiedTimeNS;
+    std::vector<UnscannedEntry> UnscannedEntries;
+  };
+  typedef std::map<std::string, SharedIncludeLines> SharedCacheType;
+  SharedCacheType SharedCache;
+  SharedCacheType SharedCacheAdditions;
+  std::string SharedCacheFileName;
+  bool SharedCacheLoaded;
+  bool SharedCacheValid;
+  // Number of records read from the file, including replaced ones.
+  size_t SharedCacheRecords;
+  long ScanStartTime;
+
+  bool FindInSharedCache(std::string const& fullName);
+  bool SharedRecordIsCurrent(std::string const& fileName,
+                             SharedIncludeLines const& shared) const;
+  bool ReadSharedCacheFile(SharedCacheType& cache, size_t& records) const;
+  void WriteSharedCacheFile() const;
+  void AppendSharedCacheFile() const;
+  void CompactSharedCacheFile() const;
+  void WriteSharedCacheHeader(std::ostream& os) const;
+  static void WriteSharedCacheRecord(std::ostream& os,
+                                     std::string const& fileName,
+                                     SharedIncludeLines const& shared);
 private:
   cmDependsC(cmDependsC const&); // Purposely not implemented.
   void operator=(cmDependsC const&); // Purposely not implemented.
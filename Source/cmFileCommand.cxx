@@ -435,7 +435,7 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
   int limit_input = -1;
   int limit_output = -1;
   unsigned int limit_count = 0;
-  cmsys::RegularExpression regex;
+  cmsys::RegularExpression* regex = 0;
   bool have_regex = false;
   bool newline_consume = false;
   bool hex_conversion_enabled = true;
@@ -551,7 +551,9 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
       }
     else if(arg_mode == arg_regex)
       {
-      if(!regex.compile(args[i].c_str()))
+      regex = this->Makefile->GetCMakeInstance()
+        ->GetRegularExpressionCache()->Get(args[i]);
+      if(!regex)
         {
         cmOStringStream e;
         e << "STRINGS option REGEX value \""
@@ -693,7 +695,7 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
       // string matches the requirements.  The length may now be as
       // low as zero since blank lines are allowed.
       if(s.length() >= minlen &&
-         (!have_regex || regex.find(s.c_str())))
+         (!have_regex || regex->find(s.c_str())))
         {
         output_size += static_cast<int>(s.size()) + 1;
         if(limit_output >= 0 && output_size >= limit_output)
@@ -713,7 +715,7 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
       // string matches the requirements.  We require that the length
       // be at least one no matter what the user specified.
       if(s.length() >= minlen && s.length() >= 1 &&
-      (!have_regex || regex.find(s.c_str())))
+      (!have_regex || regex->find(s.c_str())))
         {
         output_size += static_cast<int>(s.size()) + 1;
         if(limit_output >= 0 && output_size >= limit_output)
@@ -737,7 +739,7 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
       {
       // Terminate a string if the maximum length is reached.
       if(s.length() >= minlen &&
-         (!have_regex || regex.find(s.c_str())))
+         (!have_regex || regex->find(s.c_str())))
         {
         output_size += static_cast<int>(s.size()) + 1;
         if(limit_output >= 0 && output_size >= limit_output)
@@ -756,7 +758,7 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
   // matches the requirements.
   if((!limit_count || strings.size() < limit_count) &&
      !s.empty() && s.length() >= minlen &&
-     (!have_regex || regex.find(s.c_str())))
+     (!have_regex || regex->find(s.c_str())))
     {
     output_size += static_cast<int>(s.size()) + 1;
     if(limit_output < 0 || output_size < limit_output)
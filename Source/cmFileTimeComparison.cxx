@@ -10,6 +10,7 @@
   See the License for more information.
 ============================================================================*/
 #include "cmFileTimeComparison.h"
+#include "cmSystemTools.h"
 
 // Use a hash table to avoid duplicate file time checks from disk.
 #if defined(CMAKE_BUILD_WITH_CMAKE)
@@ -32,11 +33,21 @@
 class cmFileTimeComparisonInternal
 {
 public:
+  cmFileTimeComparisonInternal(): Lookups(0), StatCalls(0) {}
+
   // Internal comparison method.
   inline bool FileTimeCompare(const char* f1, const char* f2, int* result);
 
   bool FileTimesDiffer(const char* f1, const char* f2);
 
+  bool FileTime(const char* fname, long* sec, long* nsec);
+
+  bool FileExists(const char* fname);
+
+  // Count the files looked up and how many of them reached the disk.
+  unsigned long Lookups;
+  unsigned long StatCalls;
+
 private:
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   // Use a hash table to efficiently map from file name to modification time.
@@ -66,6 +77,7 @@ private:
 bool cmFileTimeComparisonInternal::Stat(const char* fname,
                                         cmFileTimeComparison_Type* st)
 {
+  ++this->Lookups;
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   // Use the stored time if available.
   cmFileTimeComparisonInternal::FileStatsMap::iterator fit =
@@ -77,6 +89,7 @@ bool cmFileTimeComparisonInternal::Stat(const char* fname,
     }
 #endif
 
+  ++this->StatCalls;
 #if !defined(_WIN32) || defined(__CYGWIN__)
   // POSIX version.  Use the stat function.
   int res = ::stat(fname, st);
@@ -115,6 +128,14 @@ cmFileTimeComparison::cmFileTimeComparison()
 //----------------------------------------------------------------------------
 cmFileTimeComparison::~cmFileTimeComparison()
 {
+  if(this->Internals->Lookups > 0 &&
+     cmSystemTools::GetEnv("CMAKE_FILE_TIME_STATISTICS"))
+    {
+    cmOStringStream msg;
+    msg << "File time lookups: " << this->Internals->Lookups
+        << " (" << this->Internals->StatCalls << " from disk)";
+    cmSystemTools::Message(msg.str().c_str());
+    }
   delete this->Internals;
 }
 
@@ -131,6 +152,18 @@ bool cmFileTimeComparison::FileTimesDiffer(const char* f1, const char* f2)
   return this->Internals->FileTimesDiffer(f1, f2);
 }
 
+//----------------------------------------------------------------------------
+bool cmFileTimeComparison::FileTime(const char* f, long* sec, long* nsec)
+{
+  return this->Internals->FileTime(f, sec, nsec);
+}
+
+//----------------------------------------------------------------------------
+bool cmFileTimeComparison::FileExists(const char* f)
+{
+  return this->Internals->FileExists(f);
+}
+
 //----------------------------------------------------------------------------
 int cmFileTimeComparisonInternal::Compare(cmFileTimeComparison_Type* s1,
                                           cmFileTimeComparison_Type* s2)
@@ -275,3 +308,43 @@ bool cmFileTimeComparisonInternal::FileTimesDiffer(const char* f1,
     return true;
     }
 }
+
+//----------------------------------------------------------------------------
+bool cmFileTimeComparisonInternal::FileExists(const char* fname)
+{
+  // A file that can be stat'ed exists.  Its time is kept for later
+  // comparisons, which are usually what the caller does next.
+  cmFileTimeComparison_Type st;
+  return this->Stat(fname, &st);
+}
+
+//----------------------------------------------------------------------------
+bool cmFileTimeComparisonInternal::FileTime(const char* fname,
+                                            long* sec, long* nsec)
+{
+  cmFileTimeComparison_Type st;
+  if(!this->Stat(fname, &st))
+    {
+    *sec = 0;
+    *nsec = 0;
+    return false;
+    }
+#if !defined(_WIN32) || defined(__CYGWIN__)
+# if cmsys_STAT_HAS_ST_MTIM
+  *sec = static_cast<long>(st.st_mtim.tv_sec);
+  *nsec = static_cast<long>(st.st_mtim.tv_nsec);
+# else
+  *sec = static_cast<long>(st.st_mtime);
+  *nsec = 0;
+# endif
+#else
+  // Times are integers in units of 100ns since 1601.
+  LARGE_INTEGER t;
+  t.LowPart = st.dwLowDateTime;
+  t.HighPart = st.dwHighDateTime;
+  *sec = static_cast<long>(t.QuadPart / 10000000 -
+                           static_cast<LONGLONG>(116444736) * 100);
+  *nsec = static_cast<long>(t.QuadPart % 10000000) * 100;
+#endif
+  return true;
+}
@@ -41,6 +41,19 @@ public:
    */
   bool FileTimesDiffer(const char* f1, const char* f2);
 
+  /**
+   *  Get the modification time of a file as seconds since the epoch
+   *  and nanoseconds, with the resolution used by the comparisons.
+   *  Return false if the file does not exist.
+   */
+  bool FileTime(const char* f, long* sec, long* nsec);
+
+  /**
+   *  Return true if the file exists.  A file whose modification time
+   *  is already known is not looked up on disk again.
+   */
+  bool FileExists(const char* f);
+
 protected:
 
   cmFileTimeComparisonInternal* Internals;
@@ -22,10 +22,101 @@
 #include "cmGeneratorExpressionParser.h"
 #include "cmGeneratorExpressionDAGChecker.h"
 
+//----------------------------------------------------------------------------
+// The evaluators of a parsed expression refer into the text they were
+// parsed from, so the shared parse keeps its own copy of it.
+struct cmGeneratorExpressionParsedInput
+{
+  cmGeneratorExpressionParsedInput(std::string const& input):
+    Input(input), NeedsEvaluation(false), RefCount(0) {}
+  ~cmGeneratorExpressionParsedInput()
+    {
+    for(std::vector<cmGeneratorExpressionEvaluator*>::const_iterator it
+          = this->Evaluators.begin(); it != this->Evaluators.end(); ++it)
+      {
+      delete *it;
+      }
+    }
+  void Release()
+    {
+    if(--this->RefCount == 0)
+      {
+      delete this;
+      }
+    }
+
+  const std::string Input;
+  std::vector<cmGeneratorExpressionEvaluator*> Evaluators;
+  bool NeedsEvaluation;
+  unsigned int RefCount;
+};
+
+//----------------------------------------------------------------------------
+static cmGeneratorExpressionParsedInput*
+cmGeneratorExpressionParse(std::string const& input)
+{
+  cmGeneratorExpressionParsedInput* parsed =
+    new cmGeneratorExpressionParsedInput(input);
+  cmGeneratorExpressionLexer l;
+  std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(parsed->Input);
+  parsed->NeedsEvaluation = l.GetSawGeneratorExpression();
+  if (parsed->NeedsEvaluation)
+    {
+    cmGeneratorExpressionParser p(tokens);
+    p.Parse(parsed->Evaluators);
+    }
+  return parsed;
+}
+
+//----------------------------------------------------------------------------
+cmGeneratorExpressionParseCache::cmGeneratorExpressionParseCache():
+  ParseCount(0), Hits(0)
+{
+}
+
+//----------------------------------------------------------------------------
+cmGeneratorExpressionParseCache::~cmGeneratorExpressionParseCache()
+{
+  this->Clear();
+}
+
+//----------------------------------------------------------------------------
+void cmGeneratorExpressionParseCache::Clear()
+{
+  for(MapType::const_iterator i = this->Parsed.begin();
+      i != this->Parsed.end(); ++i)
+    {
+    i->second->Release();
+    }
+  this->Parsed.clear();
+  this->ParseCount = 0;
+  this->Hits = 0;
+}
+
+//----------------------------------------------------------------------------
+cmGeneratorExpressionParsedInput*
+cmGeneratorExpressionParseCache::Get(std::string const& input)
+{
+  ++this->ParseCount;
+  MapType::iterator i = this->Parsed.find(input);
+  if(i != this->Parsed.end())
+    {
+    ++this->Hits;
+    return i->second;
+    }
+  cmGeneratorExpressionParsedInput* parsed =
+    cmGeneratorExpressionParse(input);
+  this->Parsed.insert(MapType::value_type(input, parsed));
+  // The table holds a reference of its own.
+  ++parsed->RefCount;
+  return parsed;
+}
+
 //----------------------------------------------------------------------------
 cmGeneratorExpression::cmGeneratorExpression(
-  cmListFileBacktrace const* backtrace):
-  Backtrace(backtrace)
+  cmListFileBacktrace const* backtrace,
+  cmGeneratorExpressionParseCache* cache):
+  Backtrace(backtrace), Cache(cache)
 {
 }
 
@@ -37,13 +128,13 @@ cmGeneratorExpression::Parse(std::string const& input)
   return cmsys::auto_ptr<cmCompiledGeneratorExpression>(
     new cmCompiledGeneratorExpression(
       this->Backtrace ? *this->Backtrace : cmListFileBacktrace(NULL),
-      input));
+      input, this->Cache));
 #else
   cmListFileBacktrace emptyBacktrace(NULL);
   return cmsys::auto_ptr<cmCompiledGeneratorExpression>(
     new cmCompiledGeneratorExpression(
       this->Backtrace ? *this->Backtrace : emptyBacktrace,
-      input));
+      input, this->Cache));
 #endif
 }
 
@@ -87,9 +178,9 @@ const char *cmCompiledGeneratorExpression::Evaluate(
   this->Output = "";
 
   std::vector<cmGeneratorExpressionEvaluator*>::const_iterator it
-                                                  = this->Evaluators.begin();
+                                          = this->Parsed->Evaluators.begin();
   const std::vector<cmGeneratorExpressionEvaluator*>::const_iterator end
-                                                  = this->Evaluators.end();
+                                          = this->Parsed->Evaluators.end();
 
   cmGeneratorExpressionContext context;
   context.Makefile = mf;
@@ -134,39 +225,27 @@ const char *cmCompiledGeneratorExpression::Evaluate(
   return this->Output.c_str();
 }
 
+//----------------------------------------------------------------------------
 cmCompiledGeneratorExpression::cmCompiledGeneratorExpression(
               cmListFileBacktrace const& backtrace,
-              const std::string& input)
-  : Backtrace(backtrace), Input(input),
+              const std::string& input,
+              cmGeneratorExpressionParseCache* cache)
+  : Backtrace(backtrace), Parsed(0), Input(input),
     HadContextSensitiveCondition(false),
     HadHeadSensitiveCondition(false),
     EvaluateForBuildsystem(false)
 {
-  cmGeneratorExpressionLexer l;
-  std::vector<cmGeneratorExpressionToken> tokens =
-                                              l.Tokenize(this->Input);
-  this->NeedsEvaluation = l.GetSawGeneratorExpression();
-
-  if (this->NeedsEvaluation)
-    {
-    cmGeneratorExpressionParser p(tokens);
-    p.Parse(this->Evaluators);
-    }
+  this->Parsed = cache? cache->Get(this->Input)
+                      : cmGeneratorExpressionParse(this->Input);
+  ++this->Parsed->RefCount;
+  this->NeedsEvaluation = this->Parsed->NeedsEvaluation;
 }
 
 
 //----------------------------------------------------------------------------
 cmCompiledGeneratorExpression::~cmCompiledGeneratorExpression()
 {
-  std::vector<cmGeneratorExpressionEvaluator*>::const_iterator it
-                                                  = this->Evaluators.begin();
-  const std::vector<cmGeneratorExpressionEvaluator*>::const_iterator end
-                                                  = this->Evaluators.end();
-
-  for ( ; it != end; ++it)
-    {
-    delete *it;
-    }
+  this->Parsed->Release();
 }
 
 //----------------------------------------------------------------------------
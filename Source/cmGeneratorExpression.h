@@ -25,9 +25,41 @@ class cmListFileBacktrace;
 
 struct cmGeneratorExpressionEvaluator;
 struct cmGeneratorExpressionDAGChecker;
+struct cmGeneratorExpressionParsedInput;
 
 class cmCompiledGeneratorExpression;
 
+/** \class cmGeneratorExpressionParseCache
+ * \brief Share the parsed form of generator expressions by input text.
+ *
+ * Parsing depends only on the input text, so compiled expressions given
+ * the same cache and text share one parse.  Compiled expressions keep
+ * the parse they use alive after the cache drops it.
+ */
+class cmGeneratorExpressionParseCache
+{
+public:
+  cmGeneratorExpressionParseCache();
+  ~cmGeneratorExpressionParseCache();
+
+  /** Number of expressions compiled with this cache and how many of
+   *  them reused an earlier parse.  */
+  unsigned long GetParseCount() const { return this->ParseCount; }
+  unsigned long GetHits() const { return this->Hits; }
+
+  /** Drop all parses and reset the counters.  */
+  void Clear();
+
+private:
+  friend class cmCompiledGeneratorExpression;
+  cmGeneratorExpressionParsedInput* Get(std::string const& input);
+
+  typedef std::map<std::string, cmGeneratorExpressionParsedInput*> MapType;
+  MapType Parsed;
+  unsigned long ParseCount;
+  unsigned long Hits;
+};
+
 /** \class cmGeneratorExpression
  * \brief Evaluate generate-time query expression syntax.
  *
@@ -40,8 +72,10 @@ class cmCompiledGeneratorExpression;
 class cmGeneratorExpression
 {
 public:
-  /** Construct. */
-  cmGeneratorExpression(cmListFileBacktrace const* backtrace = NULL);
+  /** Construct.  Expressions parsed with a cache share parses of the
+      same text.  */
+  cmGeneratorExpression(cmListFileBacktrace const* backtrace = NULL,
+                        cmGeneratorExpressionParseCache* cache = NULL);
   ~cmGeneratorExpression();
 
   cmsys::auto_ptr<cmCompiledGeneratorExpression> Parse(
@@ -71,6 +105,7 @@ private:
   void operator=(const cmGeneratorExpression &);
 
   cmListFileBacktrace const* Backtrace;
+  cmGeneratorExpressionParseCache* Cache;
 };
 
 class cmCompiledGeneratorExpression
@@ -126,7 +161,8 @@ public:
 
 private:
   cmCompiledGeneratorExpression(cmListFileBacktrace const& backtrace,
-              const std::string& input);
+              const std::string& input,
+              cmGeneratorExpressionParseCache* cache);
 
   friend class cmGeneratorExpression;
 
@@ -134,7 +170,7 @@ private:
   void operator=(const cmCompiledGeneratorExpression &);
 
   cmListFileBacktrace Backtrace;
-  std::vector<cmGeneratorExpressionEvaluator*> Evaluators;
+  cmGeneratorExpressionParsedInput* Parsed;
   const std::string Input;
   bool NeedsEvaluation;
 
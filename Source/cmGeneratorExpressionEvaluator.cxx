@@ -15,6 +15,7 @@
 #include "cmGeneratorExpressionParser.h"
 #include "cmGeneratorExpressionDAGChecker.h"
 #include "cmGeneratorExpression.h"
+#include "cmGlobalGenerator.h"
 #include "cmLocalGenerator.h"
 #include "cmSourceFile.h"
 
@@ -825,7 +826,10 @@ getLinkedTargetsContent(
     }
   if(!depString.empty())
     {
-    cmGeneratorExpression ge(&context->Backtrace);
+    cmGeneratorExpression ge(&context->Backtrace,
+                             context->Makefile->GetLocalGenerator()
+                               ->GetGlobalGenerator()
+                               ->GetGeneratorExpressionParseCache());
     cmsys::auto_ptr<cmCompiledGeneratorExpression> cge = ge.Parse(depString);
     linkedTargetsContent = cge->Evaluate(target->GetMakefile(),
                                          context->Config,
@@ -1181,7 +1185,10 @@ static const struct TargetPropertyNode : public cmGeneratorExpressionNode
       }
     if(!interfacePropertyName.empty())
       {
-      cmGeneratorExpression ge(&context->Backtrace);
+      cmGeneratorExpression ge(&context->Backtrace,
+                               context->Makefile->GetLocalGenerator()
+                                 ->GetGlobalGenerator()
+                                 ->GetGeneratorExpressionParseCache());
       cmsys::auto_ptr<cmCompiledGeneratorExpression> cge = ge.Parse(prop);
       cge->SetEvaluateForBuildsystem(context->EvaluateForBuildsystem);
       std::string result = cge->Evaluate(context->Makefile,
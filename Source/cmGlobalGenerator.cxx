@@ -29,6 +29,7 @@
 #include "cmGeneratorExpressionEvaluationFile.h"
 #include "cmExportBuildFileGenerator.h"
 #include "cmCPackPropertiesGenerator.h"
+#include "cmProfiler.h"
 
 #include <cmsys/Directory.hxx>
 #include <cmsys/FStream.hxx>
@@ -41,6 +42,11 @@
 
 #include <assert.h>
 
+#if !defined(_WIN32)
+# include <sys/time.h>
+# include <sys/resource.h> // getrusage
+#endif
+
 cmGlobalGenerator::cmGlobalGenerator()
 {
   // By default the .SYMBOLIC dependency is not needed on symbolic rules.
@@ -1135,6 +1141,35 @@ void cmGlobalGenerator::Configure()
   // so create the map from project name to vector of local generators
   this->FillProjectMap();
 
+  if (this->CMakeInstance->GetDebugOutput())
+    {
+    unsigned long lookups = 0;
+    unsigned long fullPath = 0;
+    for(std::vector<cmLocalGenerator*>::const_iterator
+          i = this->LocalGenerators.begin();
+        i != this->LocalGenerators.end(); ++i)
+      {
+      lookups += (*i)->GetMakefile()->GetSourceLookupCount();
+      fullPath += (*i)->GetMakefile()->GetSourceLookupFullPathCount();
+      }
+    cmOStringStream msg;
+    msg << "   Source file lookups: " << lookups
+        << " (" << fullPath << " by full path)";
+    cmSystemTools::Message(msg.str().c_str());
+    cmListFileCache* lfc = this->CMakeInstance->GetListFileCache();
+    cmOStringStream lfmsg;
+    lfmsg << "   List files read: " << lfc->GetReads()
+          << " (" << lfc->GetHits() << " from cache) in "
+          << lfc->GetReadTime() << "s";
+    cmSystemTools::Message(lfmsg.str().c_str());
+    cmRegularExpressionCache* rec =
+      this->CMakeInstance->GetRegularExpressionCache();
+    cmOStringStream remsg;
+    remsg << "   Regular expressions used: " << rec->GetLookups()
+          << " (" << rec->GetHits() << " from cache)";
+    cmSystemTools::Message(remsg.str().c_str());
+    }
+
   if ( this->CMakeInstance->GetWorkingMode() == cmake::NORMAL_MODE)
     {
     cmOStringStream msg;
@@ -1211,6 +1246,8 @@ void cmGlobalGenerator::DoGenerate()
 
 void cmGlobalGenerator::Generate()
 {
+  double generateStart = cmSystemTools::GetTime();
+
   // Check whether this generator is allowed to run.
   if(!this->CheckALLOW_DUPLICATE_CUSTOM_TARGETS())
     {
@@ -1250,8 +1287,13 @@ void cmGlobalGenerator::Generate()
     this->LocalGenerators[i]->AddHelperCommands();
     }
 
+  cmProfiler* profiler = this->CMakeInstance->GetProfiler();
+
   // Create per-target generator information.
+  {
+  cmProfilerScope profile(profiler, "generate", "CreateGeneratorTargets");
   this->CreateGeneratorTargets();
+  }
 
   this->ForceLinkerLanguages();
 
@@ -1265,10 +1307,13 @@ void cmGlobalGenerator::Generate()
 
   // Trace the dependencies, after that no custom commands should be added
   // because their dependencies might not be handled correctly
+  {
+  cmProfilerScope profile(profiler, "generate", "TraceDependencies");
   for (i = 0; i < this->LocalGenerators.size(); ++i)
     {
     this->LocalGenerators[i]->TraceDependencies();
     }
+  }
 
   // Compute the manifest of main targets generated.
   for (i = 0; i < this->LocalGenerators.size(); ++i)
@@ -1279,10 +1324,13 @@ void cmGlobalGenerator::Generate()
   this->ProcessEvaluationFiles();
 
   // Compute the inter-target dependencies.
+  {
+  cmProfilerScope profile(profiler, "generate", "ComputeTargetDepends");
   if(!this->ComputeTargetDepends())
     {
     return;
     }
+  }
 
   // Create a map from local generator to the complete set of targets
   // it builds by default.
@@ -1291,6 +1339,8 @@ void cmGlobalGenerator::Generate()
   // Generate project files
   for (i = 0; i < this->LocalGenerators.size(); ++i)
     {
+    cmProfilerScope profile(profiler, "generate",
+      this->LocalGenerators[i]->GetMakefile()->GetStartOutputDirectory());
     this->LocalGenerators[i]->GetMakefile()->SetGeneratingBuildSystem();
     this->SetCurrentLocalGenerator(this->LocalGenerators[i]);
     this->LocalGenerators[i]->Generate();
@@ -1352,6 +1402,35 @@ void cmGlobalGenerator::Generate()
     this->GetCMakeInstance()->IssueMessage(cmake::AUTHOR_WARNING, w.str());
     }
 
+  if(this->CMakeInstance->GetDebugOutput())
+    {
+    cmOStringStream msg;
+    msg << "   Generator expressions compiled: "
+        << this->GeneratorExpressionParseCache.GetParseCount()
+        << " (" << this->GeneratorExpressionParseCache.GetHits()
+        << " reused a parse)";
+    cmSystemTools::Message(msg.str().c_str());
+    cmOStringStream tmsg;
+    tmsg << "   Generate time: "
+         << (cmSystemTools::GetTime() - generateStart) << "s";
+    cmSystemTools::Message(tmsg.str().c_str());
+#if !defined(_WIN32)
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0)
+      {
+      // The peak resident set size is in bytes on OS X and KiB elsewhere.
+      long peak = static_cast<long>(usage.ru_maxrss);
+# if defined(__APPLE__)
+      peak /= 1024;
+# endif
+      cmOStringStream mmsg;
+      mmsg << "   Peak memory: " << peak << " KiB";
+      cmSystemTools::Message(mmsg.str().c_str());
+      }
+#endif
+    }
+  this->GeneratorExpressionParseCache.Clear();
+
   this->CMakeInstance->UpdateProgress("Generating done", -1);
 }
 
@@ -1530,6 +1609,8 @@ void cmGlobalGenerator::ClearGeneratorMembers()
     }
   this->LocalGenerators.clear();
 
+  this->GeneratorExpressionParseCache.Clear();
+
   this->ExportSets.clear();
   this->TargetDependencies.clear();
   this->TotalTargets.clear();
@@ -2973,15 +3054,24 @@ void cmGlobalGenerator::WriteSummary(cmTarget* target)
 // static
 std::string cmGlobalGenerator::EscapeJSON(const std::string& s) {
   std::string result;
-  for (std::string::size_type i = 0; i < s.size(); ++i) {
-    if (s[i] == '"' || s[i] == '\\') {
-      result += '\\';
-    }
-    result += s[i];
-  }
+  cmGlobalGenerator::AppendEscapedJSON(result, s);
   return result;
 }
 
+//----------------------------------------------------------------------------
+void cmGlobalGenerator::AppendEscapedJSON(std::string& out,
+                                          const std::string& s)
+{
+  for (std::string::const_iterator i = s.begin(); i != s.end(); ++i)
+    {
+    if (*i == '"' || *i == '\\')
+      {
+      out += '\\';
+      }
+    out += *i;
+    }
+}
+
 //----------------------------------------------------------------------------
 void cmGlobalGenerator::AddEvaluationFile(const std::string &inputFile,
                     cmsys::auto_ptr<cmCompiledGeneratorExpression> outputExpr,
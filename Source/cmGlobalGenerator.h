@@ -159,6 +159,10 @@ public:
   ///! Get the CMake instance
   cmake *GetCMakeInstance() const { return this->CMakeInstance; }
 
+  /** Parses shared by generator expressions evaluated in this tree.  */
+  cmGeneratorExpressionParseCache* GetGeneratorExpressionParseCache()
+    { return &this->GeneratorExpressionParseCache; }
+
   void SetConfiguredFilesPath(cmGlobalGenerator* gen);
   const std::vector<cmLocalGenerator *>& GetLocalGenerators() const {
     return this->LocalGenerators;}
@@ -297,8 +301,8 @@ public:
   void FileReplacedDuringGenerate(const std::string& filename);
   void GetFilesReplacedDuringGenerate(std::vector<std::string>& filenames);
 
-  void AddRuleHash(const std::vector<std::string>& outputs,
-                   std::string const& content);
+  virtual void AddRuleHash(const std::vector<std::string>& outputs,
+                           std::string const& content);
 
   /** Return whether the given binary directory is unused.  */
   bool BinaryDirectoryIsNew(const std::string& dir)
@@ -319,6 +323,9 @@ public:
 
   static std::string EscapeJSON(const std::string& s);
 
+  /** Append @a s to @a out escaped as the contents of a JSON string.  */
+  static void AppendEscapedJSON(std::string& out, const std::string& s);
+
   void AddEvaluationFile(const std::string &inputFile,
                   cmsys::auto_ptr<cmCompiledGeneratorExpression> outputName,
                   cmMakefile *makefile,
@@ -421,6 +428,10 @@ protected:
   virtual bool UseFolderProperty();
   void EnableMinGWLanguage(cmMakefile *mf);
 
+  // Record hashes for rules and outputs.
+  struct RuleHash { char Data[32]; };
+  std::map<std::string, RuleHash> RuleHashes;
+
 private:
   cmMakefile* TryCompileOuterMakefile;
   float FirstTimeProgress;
@@ -435,9 +446,6 @@ private:
   std::map<std::string, int> LanguageToLinkerPreference;
   std::map<std::string, std::string> LanguageToOriginalSharedLibFlags;
 
-  // Record hashes for rules and outputs.
-  struct RuleHash { char Data[32]; };
-  std::map<std::string, RuleHash> RuleHashes;
   void CheckRuleHashes();
   void CheckRuleHashes(std::string const& pfile, std::string const& home);
   void WriteRuleHashes(std::string const& pfile);
@@ -458,6 +466,8 @@ private:
   // track files replaced during a Generate
   std::vector<std::string> FilesReplacedDuringGenerate;
 
+  cmGeneratorExpressionParseCache GeneratorExpressionParseCache;
+
   // Store computed inter-target dependencies.
   typedef std::map<cmTarget const*, TargetDependSet> TargetDependMap;
   TargetDependMap TargetDependencies;
@@ -110,6 +110,78 @@ std::string cmGlobalNinjaGenerator::EncodeDepfileSpace(const std::string &path)
   return result;
 }
 
+void cmGlobalNinjaGenerator::AppendBuildPath(std::string& out,
+                                             const std::string& path,
+                                             std::ostream& vars)
+{
+  // Same as EncodePath, in one pass over a reused buffer.
+  std::string& encoded = this->PathBuffer;
+  encoded.clear();
+  bool ident = true;
+  for(std::string::const_iterator i = path.begin(); i != path.end(); ++i)
+    {
+    char c = *i;
+#ifdef _WIN32
+    if(UsingMinGW && c == '\\')
+      c = '/';
+    else if(!UsingMinGW && c == '/')
+      c = '\\';
+#endif
+    if(c == '$' || c == '\n')
+      encoded += '$';
+    encoded += c;
+    ident = ident && IsIdentChar(c);
+    }
+
+  // Paths that cannot be written as identifiers are rare, so let
+  // EncodeIdent bind a variable for them.
+  if(!ident)
+    {
+    out += EncodeIdent(encoded, vars);
+    return;
+    }
+  for(std::string::const_iterator i = encoded.begin();
+      i != encoded.end(); ++i)
+    {
+    if(*i == ' ' || *i == ':')
+      out += '$';
+    out += *i;
+    }
+}
+
+void cmGlobalNinjaGenerator::AppendVariable(std::string& out,
+                                            const std::string& name,
+                                            const std::string& value,
+                                            int indent)
+{
+  // Make sure we have a name.
+  if(name.empty())
+    {
+    cmSystemTools::Error("No name given for WriteVariable!");
+    return;
+    }
+
+  // Do not add a variable if the value is empty.  The whitespace is
+  // trimmed as cmSystemTools::TrimWhitespace does, without a copy.
+  std::string::const_iterator start = value.begin();
+  while(start != value.end() && *start <= ' ')
+    ++start;
+  if(start == value.end())
+    {
+    return;
+    }
+  std::string::const_iterator stop = value.end()-1;
+  while(*stop <= ' ')
+    --stop;
+
+  for(int i = 0; i < indent; ++i)
+    out += cmGlobalNinjaGenerator::INDENT;
+  out += name;
+  out += " = ";
+  out.append(start, stop+1);
+  out += '\n';
+}
+
 void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
                                         const std::string& comment,
                                         const std::string& rule,
@@ -141,7 +213,10 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
 
   cmGlobalNinjaGenerator::WriteComment(os, comment);
 
-  std::string arguments;
+  // The statement is assembled in buffers kept across calls because
+  // identifiers that need a variable must be written to os first.
+  std::string& arguments = this->ArgumentsBuffer;
+  arguments.clear();
 
   // TODO: Better formatting for when there are multiple input/output files.
 
@@ -150,7 +225,8 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
       i != explicitDeps.end();
       ++i)
     {
-    arguments += " " + EncodeIdent(EncodePath(*i), os);
+    arguments += ' ';
+    this->AppendBuildPath(arguments, *i, os);
     }
 
   // Write implicit dependencies.
@@ -160,7 +236,10 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
     for(cmNinjaDeps::const_iterator i = implicitDeps.begin();
         i != implicitDeps.end();
         ++i)
-      arguments += " " + EncodeIdent(EncodePath(*i), os);
+      {
+      arguments += ' ';
+      this->AppendBuildPath(arguments, *i, os);
+      }
     }
 
   // Write order-only dependencies.
@@ -170,48 +249,51 @@ void cmGlobalNinjaGenerator::WriteBuild(std::ostream& os,
     for(cmNinjaDeps::const_iterator i = orderOnlyDeps.begin();
         i != orderOnlyDeps.end();
         ++i)
-      arguments += " " + EncodeIdent(EncodePath(*i), os);
+      {
+      arguments += ' ';
+      this->AppendBuildPath(arguments, *i, os);
+      }
     }
 
-  arguments += "\n";
+  arguments += '\n';
 
-  std::string build;
+  std::string& build = this->BuildBuffer;
 
   // Write outputs files.
-  build += "build";
+  build = "build";
   for(cmNinjaDeps::const_iterator i = outputs.begin();
       i != outputs.end(); ++i)
     {
-    build += " " + EncodeIdent(EncodePath(*i), os);
-    this->CombinedBuildOutputs.insert( EncodePath(*i) );
+    build += ' ';
+    this->AppendBuildPath(build, *i, os);
+    this->CombinedBuildOutputs.insert(this->PathBuffer);
     }
-  build += ":";
+  build += ':';
 
   // Write the rule.
-  build += " " + rule;
+  build += ' ';
+  build += rule;
 
   // Write the variables bound to this build statement.
-  cmOStringStream variable_assignments;
+  std::string& assignments = this->AssignmentsBuffer;
+  assignments.clear();
   for(cmNinjaVars::const_iterator i = variables.begin();
       i != variables.end(); ++i)
-    cmGlobalNinjaGenerator::WriteVariable(variable_assignments,
-                                          i->first, i->second, "", 1);
+    {
+    cmGlobalNinjaGenerator::AppendVariable(assignments,
+                                           i->first, i->second, 1);
+    }
 
   // check if a response file rule should be used
-  std::string buildstr = build;
-  std::string assignments = variable_assignments.str();
-  const std::string& args = arguments;
   if (cmdLineLimit > 0
-      && args.size() + buildstr.size() + assignments.size()
+      && arguments.size() + build.size() + assignments.size()
                                                     > (size_t) cmdLineLimit) {
-    buildstr += "_RSP_FILE";
-    variable_assignments.clear();
-    cmGlobalNinjaGenerator::WriteVariable(variable_assignments,
-                                          "RSP_FILE", rspfile, "", 1);
-    assignments += variable_assignments.str();
+    build += "_RSP_FILE";
+    cmGlobalNinjaGenerator::AppendVariable(assignments,
+                                           "RSP_FILE", rspfile, 1);
   }
 
-  os << buildstr << args << assignments;
+  os << build << arguments << assignments;
 }
 
 void cmGlobalNinjaGenerator::WritePhonyBuild(std::ostream& os,
@@ -252,7 +334,8 @@ cmGlobalNinjaGenerator::WriteCustomCommandBuild(const std::string& command,
                                                 const std::string& comment,
                                                 const cmNinjaDeps& outputs,
                                                 const cmNinjaDeps& deps,
-                                                const cmNinjaDeps& orderOnly)
+                                                const cmNinjaDeps& orderOnly,
+                                                const std::string& pool)
 {
   std::string cmd = command;
 #ifdef _WIN32
@@ -266,6 +349,10 @@ cmGlobalNinjaGenerator::WriteCustomCommandBuild(const std::string& command,
   cmNinjaVars vars;
   vars["COMMAND"] = cmd;
   vars["DESC"] = EncodeLiteral(description);
+  if (!pool.empty())
+    {
+    vars["pool"] = pool;
+    }
 
   this->WriteBuild(*this->BuildFileStream,
                    comment,
@@ -424,25 +511,45 @@ void cmGlobalNinjaGenerator::WriteVariable(std::ostream& os,
                                            const std::string& comment,
                                            int indent)
 {
-  // Make sure we have a name.
-  if(name.empty())
-    {
-    cmSystemTools::Error("No name given for WriteVariable! called "
-                         "with comment: ",
-                         comment.c_str());
-    return;
-    }
+  std::string assignment;
+  cmGlobalNinjaGenerator::AppendVariable(assignment, name, value, indent);
 
   // Do not add a variable if the value is empty.
-  std::string val = cmSystemTools::TrimWhitespace(value);
-  if(val.empty())
+  if(assignment.empty())
     {
     return;
     }
 
   cmGlobalNinjaGenerator::WriteComment(os, comment);
-  cmGlobalNinjaGenerator::Indent(os, indent);
-  os << name << " = " << val << "\n";
+  os << assignment;
+}
+
+std::string cmGlobalNinjaGenerator::ShareVariable(std::ostream& os,
+                                                  const std::string& name,
+                                                  const std::string& value)
+{
+  // Empty values are not written at all, so there is nothing to share.
+  std::string::const_iterator c = value.begin();
+  while(c != value.end() && *c <= ' ')
+    ++c;
+  if(c == value.end())
+    {
+    return value;
+    }
+
+  // The value of a build statement variable is evaluated in the scope of
+  // the build file, so binding it to a reference to a build file variable
+  // gives it exactly the same value.
+  SharedValueMap& shared = this->SharedVariables[name];
+  SharedValueMap::iterator i = shared.find(value);
+  if(i == shared.end())
+    {
+    cmOStringStream var;
+    var << name << "_" << shared.size() + 1;
+    i = shared.insert(std::make_pair(value, var.str())).first;
+    cmGlobalNinjaGenerator::WriteVariable(os, i->second, value);
+    }
+  return "$" + i->second;
 }
 
 void cmGlobalNinjaGenerator::WriteInclude(std::ostream& os,
@@ -764,7 +871,7 @@ void cmGlobalNinjaGenerator::AddCXXCompileCommand(
       new cmGeneratedFileStream(buildFilePath.c_str());
     *this->CompileCommandsStream << "[";
     } else {
-    *this->CompileCommandsStream << "," << std::endl;
+    *this->CompileCommandsStream << ",\n";
     }
 
   std::string sourceFileName = sourceFile;
@@ -775,15 +882,15 @@ void cmGlobalNinjaGenerator::AddCXXCompileCommand(
       this->GetCMakeInstance()->GetHomeOutputDirectory());
     }
 
-
-  *this->CompileCommandsStream << "\n{\n"
-     << "  \"directory\": \""
-     << cmGlobalGenerator::EscapeJSON(buildFileDir) << "\",\n"
-     << "  \"command\": \""
-     << cmGlobalGenerator::EscapeJSON(commandLine) << "\",\n"
-     << "  \"file\": \""
-     << cmGlobalGenerator::EscapeJSON(sourceFileName) << "\"\n"
-     << "}";
+  std::string& entry = this->CompileCommandBuffer;
+  entry = "\n{\n  \"directory\": \"";
+  cmGlobalGenerator::AppendEscapedJSON(entry, buildFileDir);
+  entry += "\",\n  \"command\": \"";
+  cmGlobalGenerator::AppendEscapedJSON(entry, commandLine);
+  entry += "\",\n  \"file\": \"";
+  cmGlobalGenerator::AppendEscapedJSON(entry, sourceFileName);
+  entry += "\"\n}";
+  *this->CompileCommandsStream << entry;
 }
 
 void cmGlobalNinjaGenerator::CloseCompileCommandsStream()
@@ -105,7 +105,8 @@ public:
                                const std::string& comment,
                                const cmNinjaDeps& outputs,
                                const cmNinjaDeps& deps = cmNinjaDeps(),
-                               const cmNinjaDeps& orderOnly = cmNinjaDeps());
+                               const cmNinjaDeps& orderOnly = cmNinjaDeps(),
+                               const std::string& pool = std::string());
   void WriteMacOSXContentBuild(const std::string& input,
                                const std::string& output);
 
@@ -138,6 +139,16 @@ public:
                             const std::string& comment = "",
                             int indent = 0);
 
+  /**
+   * Return the value to bind to the build statement variable @a name so
+   * that it expands to @a value.  The first time a value is seen it is
+   * written to @a os as a variable of the build file named after @a name,
+   * so each distinct value appears in the build file only once.
+   */
+  std::string ShareVariable(std::ostream& os,
+                            const std::string& name,
+                            const std::string& value);
+
   /**
    * Write an include statement including @a filename with an optional
    * @a comment to the @a os stream.
@@ -335,6 +346,17 @@ private:
 
   std::string ninjaCmd() const;
 
+  /// Append @a path to @a out escaped like EncodeIdent(EncodePath(path)).
+  /// The encoded path without ident escaping is left in PathBuffer.
+  void AppendBuildPath(std::string& out, const std::string& path,
+                       std::ostream& vars);
+
+  /// Append a variable assignment to @a out.  Nothing is appended if
+  /// the value is only whitespace.  WriteVariable uses this too.
+  static void AppendVariable(std::string& out,
+                             const std::string& name,
+                             const std::string& value,
+                             int indent);
 
   /// The file containing the build statement. (the relation ship of the
   /// compilation DAG).
@@ -344,6 +366,19 @@ private:
   cmGeneratedFileStream* RulesFileStream;
   cmGeneratedFileStream* CompileCommandsStream;
 
+  /// Buffers reused by every WriteBuild and AddCXXCompileCommand call so
+  /// that large build files are written without per-statement allocation.
+  std::string BuildBuffer;
+  std::string ArgumentsBuffer;
+  std::string AssignmentsBuffer;
+  std::string PathBuffer;
+  std::string CompileCommandBuffer;
+
+  /// The build file variables written by ShareVariable, by statement
+  /// variable name and value.
+  typedef std::map<std::string, std::string> SharedValueMap;
+  std::map<std::string, SharedValueMap> SharedVariables;
+
   /// The type used to store the set of rules added to the generated build
   /// system.
   typedef std::set<std::string> RulesSetType;
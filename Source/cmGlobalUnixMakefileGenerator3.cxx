@@ -18,6 +18,13 @@
 #include "cmSourceFile.h"
 #include "cmTarget.h"
 #include "cmGeneratorTarget.h"
+#include "cmProfiler.h"
+
+#include <cmsys/FStream.hxx>
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include "cmComputeDirectoryHashes.h"
+#endif
 
 cmGlobalUnixMakefileGenerator3::cmGlobalUnixMakefileGenerator3()
 {
@@ -32,6 +39,17 @@ cmGlobalUnixMakefileGenerator3::cmGlobalUnixMakefileGenerator3()
   this->UseLinkScript = true;
 #endif
   this->CommandDatabase = NULL;
+  this->CurrentStamp = 0;
+  this->DirectoryHashes = 0;
+  this->IncrementalGenerate = false;
+}
+
+//----------------------------------------------------------------------------
+cmGlobalUnixMakefileGenerator3::~cmGlobalUnixMakefileGenerator3()
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  delete this->DirectoryHashes;
+#endif
 }
 
 void cmGlobalUnixMakefileGenerator3
@@ -129,8 +147,29 @@ void cmGlobalUnixMakefileGenerator3::Configure()
 
 void cmGlobalUnixMakefileGenerator3::Generate()
 {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Load the state of the build files written by the previous run.
+  // The file is removed until this run is complete so that an error
+  // can never cause out-of-date build files to be kept.
+  this->IncrementalGenerate =
+    !this->GetCMakeInstance()->GetIsInTryCompile() &&
+    this->LocalGenerators[0]->GetMakefile()->IsOn(
+      "CMAKE_INCREMENTAL_GENERATE");
+  this->OldStamps.clear();
+  this->NewStamps.clear();
+  this->CurrentStamp = 0;
+  delete this->DirectoryHashes;
+  this->DirectoryHashes = 0;
+  if(this->IncrementalGenerate)
+    {
+    this->ReadDirectoryStamps();
+    }
+  cmSystemTools::RemoveFile(this->GetDirectoryStampsFile());
+#endif
+
   // first do superclass method
   this->cmGlobalGenerator::Generate();
+  this->CurrentStamp = 0;
 
   // initialize progress
   unsigned long total = 0;
@@ -170,10 +209,19 @@ void cmGlobalUnixMakefileGenerator3::Generate()
   this->WriteMainCMakefile();
 
   if (this->CommandDatabase != NULL) {
-    *this->CommandDatabase << std::endl << "]";
+    *this->CommandDatabase << "\n]";
     delete this->CommandDatabase;
     this->CommandDatabase = NULL;
   }
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if(this->IncrementalGenerate && !cmSystemTools::GetErrorOccuredFlag())
+    {
+    this->WriteDirectoryStamps();
+    }
+  this->OldStamps.clear();
+  this->NewStamps.clear();
+#endif
 }
 
 void cmGlobalUnixMakefileGenerator3::AddCXXCompileCommand(
@@ -186,20 +234,242 @@ void cmGlobalUnixMakefileGenerator3::AddCXXCompileCommand(
       + "/compile_commands.json";
     this->CommandDatabase =
       new cmGeneratedFileStream(commandDatabaseName.c_str());
-    *this->CommandDatabase << "[" << std::endl;
+    *this->CommandDatabase << "[\n";
     } else {
-    *this->CommandDatabase << "," << std::endl;
+    *this->CommandDatabase << ",\n";
+    }
+  std::string& entry = this->CommandDatabaseEntry;
+  entry = "{\n  \"directory\": \"";
+  cmGlobalGenerator::AppendEscapedJSON(entry, workingDirectory);
+  entry += "\",\n  \"command\": \"";
+  cmGlobalGenerator::AppendEscapedJSON(entry, compileCommand);
+  entry += "\",\n  \"file\": \"";
+  cmGlobalGenerator::AppendEscapedJSON(entry, sourceFile);
+  entry += "\"\n}";
+  *this->CommandDatabase << entry;
+
+  if(this->CurrentStamp)
+    {
+    this->CurrentStamp->CompileCommands.push_back(sourceFile);
+    this->CurrentStamp->CompileCommands.push_back(workingDirectory);
+    this->CurrentStamp->CompileCommands.push_back(compileCommand);
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmGlobalUnixMakefileGenerator3
+::AddRuleHash(const std::vector<std::string>& outputs,
+              std::string const& content)
+{
+  this->cmGlobalGenerator::AddRuleHash(outputs, content);
+  if(this->CurrentStamp && !outputs.empty())
+    {
+    std::string fname = this->LocalGenerators[0]->Convert(
+      outputs[0], cmLocalGenerator::HOME_OUTPUT);
+    std::map<std::string, RuleHash>::const_iterator rhi =
+      this->RuleHashes.find(fname);
+    if(rhi != this->RuleHashes.end())
+      {
+      this->CurrentStamp->RuleHashes.push_back(*rhi);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmGlobalUnixMakefileGenerator3
+::ReuseGeneratedFiles(cmLocalUnixMakefileGenerator3* lg)
+{
+  this->CurrentStamp = 0;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if(!this->IncrementalGenerate)
+    {
+    return false;
+    }
+
+  // Hash the state of all directories before any is generated.
+  if(!this->DirectoryHashes)
+    {
+    cmProfilerScope profile(this->GetCMakeInstance()->GetProfiler(),
+                            "generate", "ComputeDirectoryHashes");
+    this->DirectoryHashes = new cmComputeDirectoryHashes(this);
+    this->DirectoryHashes->Compute();
+    }
+
+  cmMakefile* mf = lg->GetMakefile();
+  std::string dir = mf->GetStartOutputDirectory();
+  std::string const& hash = this->DirectoryHashes->GetHash(lg);
+
+  // The top directory lists the targets of all directories, so it is
+  // always generated.  Others are kept if nothing they depend on
+  // changed and their files are still there.
+  DirectoryStampMap::const_iterator osi = this->OldStamps.find(dir);
+  bool reuse = (lg->GetParent() && osi != this->OldStamps.end() &&
+                osi->second.Hash == hash &&
+                cmSystemTools::FileExists((dir + "/Makefile").c_str()) &&
+                cmSystemTools::FileExists(
+                  (dir + cmake::GetCMakeFilesDirectory() +
+                   "/CMakeDirectoryInformation.cmake").c_str()));
+  std::vector<std::pair<cmTarget const*, std::string> > targets;
+  if(reuse)
+    {
+    DirectoryStamp const& stamp = osi->second;
+    for(std::vector<std::pair<std::string, unsigned long> >::const_iterator
+          pi = stamp.Progress.begin(); reuse && pi != stamp.Progress.end();
+        ++pi)
+      {
+      cmTarget const* t = mf->FindTarget(pi->first);
+      if(!t)
+        {
+        reuse = false;
+        break;
+        }
+      std::string tdir = dir + "/" + lg->GetTargetDirectory(*t);
+      reuse = cmSystemTools::FileExists((tdir + "/build.make").c_str());
+      targets.push_back(std::make_pair(t, tdir));
+      }
+    }
+  if(!reuse)
+    {
+    DirectoryStamp& stamp = this->NewStamps[dir];
+    stamp = DirectoryStamp();
+    stamp.Hash = hash;
+    this->CurrentStamp = &stamp;
+    return false;
+    }
+
+  // Restore what the files of the directory contributed.
+  DirectoryStamp const& stamp = osi->second;
+  for(size_t i = 0; i < targets.size(); ++i)
+    {
+    TargetProgress& tp = this->ProgressMap[targets[i].first];
+    tp.NumberOfActions = stamp.Progress[i].second;
+    tp.VariableFile = targets[i].second + "/progress.make";
+    }
+  for(std::vector<std::pair<std::string, RuleHash> >::const_iterator
+        ri = stamp.RuleHashes.begin(); ri != stamp.RuleHashes.end(); ++ri)
+    {
+    this->RuleHashes[ri->first] = ri->second;
+    }
+  std::vector<std::string> const& cc = stamp.CompileCommands;
+  for(size_t i = 0; i + 2 < cc.size(); i += 3)
+    {
+    this->AddCXXCompileCommand(cc[i], cc[i+1], cc[i+2]);
+    }
+  this->NewStamps[dir] = stamp;
+  return true;
+#else
+  (void)lg;
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+std::string cmGlobalUnixMakefileGenerator3::GetDirectoryStampsFile()
+{
+  std::string fname = this->GetCMakeInstance()->GetHomeOutputDirectory();
+  fname += cmake::GetCMakeFilesDirectory();
+  fname += "/CMakeDirectoryHashes.txt";
+  return fname;
+}
+
+//----------------------------------------------------------------------------
+void cmGlobalUnixMakefileGenerator3::ReadDirectoryStamps()
+{
+  // See WriteDirectoryStamps for the format.
+  std::string fname = this->GetDirectoryStampsFile();
+  cmsys::ifstream fin(fname.c_str(), std::ios::in | std::ios::binary);
+  if(!fin)
+    {
+    return;
+    }
+  DirectoryStamp* stamp = 0;
+  std::string line;
+  bool okay = true;
+  while(okay && cmSystemTools::GetLineFromStream(fin, line))
+    {
+    if(line.size() > 37 && line.compare(0, 4, "dir ") == 0)
+      {
+      stamp = &this->OldStamps[line.substr(37)];
+      stamp->Hash = line.substr(4, 32);
+      }
+    else if(stamp && line.size() > 38 && line.compare(0, 5, "rule ") == 0)
+      {
+      RuleHash hash;
+      strncpy(hash.Data, line.c_str() + 5, 32);
+      stamp->RuleHashes.push_back(std::make_pair(line.substr(38), hash));
+      }
+    else if(stamp && line.compare(0, 9, "progress ") == 0)
+      {
+      std::string::size_type pos = line.find(' ', 9);
+      if(pos == line.npos)
+        {
+        okay = false;
+        continue;
+        }
+      unsigned long n = strtoul(line.c_str() + 9, 0, 10);
+      stamp->Progress.push_back(std::make_pair(line.substr(pos + 1), n));
+      }
+    else if(stamp && line.compare(0, 8, "compile ") == 0)
+      {
+      // The three values follow on one line prefixed by their sizes.
+      unsigned long sizes[3];
+      okay = sscanf(line.c_str() + 8, "%lu %lu %lu",
+                    &sizes[0], &sizes[1], &sizes[2]) == 3;
+      for(int i = 0; okay && i < 3; ++i)
+        {
+        std::string value(sizes[i], '\0');
+        okay = sizes[i] == 0 || fin.read(&value[0], sizes[i]);
+        stamp->CompileCommands.push_back(value);
+        }
+      okay = okay && cmSystemTools::GetLineFromStream(fin, line) &&
+        line.empty();
+      }
+    else if(!line.empty() && line[0] != '#')
+      {
+      okay = false;
+      }
+    }
+  if(!okay)
+    {
+    // The file is damaged.  Generate everything.
+    this->OldStamps.clear();
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmGlobalUnixMakefileGenerator3::WriteDirectoryStamps()
+{
+  // Each directory starts with a line holding its hash and name,
+  // followed by one line for each progress counter and rule hash it
+  // recorded.  Compile commands may contain newlines, so their values
+  // are written after a line holding their sizes.
+  std::string fname = this->GetDirectoryStampsFile();
+  cmGeneratedFileStream fout(fname.c_str());
+  fout << "# Hashes of the state each directory was generated from.\n";
+  for(DirectoryStampMap::const_iterator dsi = this->NewStamps.begin();
+      dsi != this->NewStamps.end(); ++dsi)
+    {
+    DirectoryStamp const& stamp = dsi->second;
+    fout << "dir " << stamp.Hash << " " << dsi->first << "\n";
+    for(std::vector<std::pair<std::string, unsigned long> >::const_iterator
+          pi = stamp.Progress.begin(); pi != stamp.Progress.end(); ++pi)
+      {
+      fout << "progress " << pi->second << " " << pi->first << "\n";
+      }
+    for(std::vector<std::pair<std::string, RuleHash> >::const_iterator
+          ri = stamp.RuleHashes.begin(); ri != stamp.RuleHashes.end(); ++ri)
+      {
+      fout << "rule ";
+      fout.write(ri->second.Data, 32);
+      fout << " " << ri->first << "\n";
+      }
+    std::vector<std::string> const& cc = stamp.CompileCommands;
+    for(size_t i = 0; i + 2 < cc.size(); i += 3)
+      {
+      fout << "compile " << cc[i].size() << " " << cc[i+1].size() << " "
+           << cc[i+2].size() << "\n" << cc[i] << cc[i+1] << cc[i+2] << "\n";
+      }
     }
-  *this->CommandDatabase << "{" << std::endl
-      << "  \"directory\": \""
-      << cmGlobalGenerator::EscapeJSON(workingDirectory) << "\","
-      << std::endl
-      << "  \"command\": \"" <<
-      cmGlobalGenerator::EscapeJSON(compileCommand) << "\","
-      << std::endl
-      << "  \"file\": \"" <<
-      cmGlobalGenerator::EscapeJSON(sourceFile) << "\""
-      << std::endl << "}";
 }
 
 void cmGlobalUnixMakefileGenerator3::WriteMainMakefile2()
@@ -955,6 +1225,11 @@ cmGlobalUnixMakefileGenerator3::RecordTargetProgress(
   TargetProgress& tp = this->ProgressMap[tg->GetTarget()];
   tp.NumberOfActions = tg->GetNumberOfProgressActions();
   tp.VariableFile = tg->GetProgressFileNameFull();
+  if(this->CurrentStamp)
+    {
+    this->CurrentStamp->Progress.push_back(
+      std::make_pair(tg->GetTarget()->GetName(), tp.NumberOfActions));
+    }
 }
 
 //----------------------------------------------------------------------------
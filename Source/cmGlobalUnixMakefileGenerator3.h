@@ -15,6 +15,7 @@
 #include "cmGlobalGenerator.h"
 #include "cmGlobalGeneratorFactory.h"
 
+class cmComputeDirectoryHashes;
 class cmGeneratedFileStream;
 class cmMakefileTargetGenerator;
 class cmLocalUnixMakefileGenerator3;
@@ -55,6 +56,7 @@ class cmGlobalUnixMakefileGenerator3 : public cmGlobalGenerator
 {
 public:
   cmGlobalUnixMakefileGenerator3();
+  ~cmGlobalUnixMakefileGenerator3();
   static cmGlobalGeneratorFactory* NewFactory() {
     return new cmGlobalGeneratorSimpleFactory
       <cmGlobalUnixMakefileGenerator3>(); }
@@ -125,6 +127,14 @@ public:
                             const std::string &workingDirectory,
                             const std::string &compileCommand);
 
+  virtual void AddRuleHash(const std::vector<std::string>& outputs,
+                           std::string const& content);
+
+  /** Return whether the build files generated for a directory by the
+      previous run are still up to date.  If so, the information they
+      contributed to the whole build system is restored.  */
+  bool ReuseGeneratedFiles(cmLocalUnixMakefileGenerator3* lg);
+
   /** Does the make tool tolerate .NOTPARALLEL? */
   virtual bool AllowNotParallel() const { return true; }
 
@@ -194,6 +204,26 @@ protected:
   size_t CountProgressMarksInAll(cmLocalUnixMakefileGenerator3* lg);
 
   cmGeneratedFileStream *CommandDatabase;
+  std::string CommandDatabaseEntry;
+
+  // Store what the build files of each directory contributed to the
+  // whole build system so that they can be kept by later runs.
+  struct DirectoryStamp
+  {
+    std::string Hash;
+    std::vector<std::pair<std::string, unsigned long> > Progress;
+    std::vector<std::pair<std::string, RuleHash> > RuleHashes;
+    std::vector<std::string> CompileCommands;
+  };
+  typedef std::map<std::string, DirectoryStamp> DirectoryStampMap;
+  DirectoryStampMap OldStamps;
+  DirectoryStampMap NewStamps;
+  DirectoryStamp* CurrentStamp;
+  cmComputeDirectoryHashes* DirectoryHashes;
+  bool IncrementalGenerate;
+  std::string GetDirectoryStampsFile();
+  void ReadDirectoryStamps();
+  void WriteDirectoryStamps();
 private:
   virtual const char* GetBuildIgnoreErrorsFlag() const { return "-i"; }
   virtual std::string GetEditCacheCommand() const;
@@ -17,7 +17,12 @@
 #include "cmMakefile.h"
 #include "cmVersion.h"
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include "cmCryptoHash.h"
+#endif
+
 #include <cmsys/RegularExpression.hxx>
+#include <cmsys/FStream.hxx>
 
 #ifdef __BORLANDC__
 # pragma warn -8060 /* possibly incorrect assignment */
@@ -38,13 +43,14 @@ struct cmListFileParser
   cmListFileLexer* Lexer;
   cmListFileFunction Function;
   enum { SeparationOkay, SeparationWarning, SeparationError} Separation;
+  bool Warned;
 };
 
 //----------------------------------------------------------------------------
 cmListFileParser::cmListFileParser(cmListFile* lf, cmMakefile* mf,
                                    const char* filename):
   ListFile(lf), Makefile(mf), FileName(filename),
-  Lexer(cmListFileLexer_New())
+  Lexer(cmListFileLexer_New()), Warned(false)
 {
 }
 
@@ -151,10 +157,8 @@ bool cmListFile::ParseFile(const char* filename,
   bool parseError = false;
   this->ModifiedTime = cmSystemTools::ModifiedTime(filename);
 
-  {
-  cmListFileParser parser(this, mf, filename);
-  parseError = !parser.ParseFile();
-  }
+  parseError =
+    !mf->GetCMakeInstance()->GetListFileCache()->Parse(this, filename, mf);
 
   if(parseError)
     {
@@ -256,6 +260,68 @@ bool cmListFile::ParseFile(const char* filename,
   return true;
 }
 
+//----------------------------------------------------------------------------
+// Identify the content a parse was made from without keeping it.
+static std::string cmListFileCacheHash(std::string const& content)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmCryptoHashMD5 md5;
+  return md5.HashString(content);
+#else
+  return content;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileCache::Parse(cmListFile* lf, const char* path, cmMakefile* mf)
+{
+  ++this->Reads;
+  double start = cmSystemTools::GetTime();
+
+  // Hash the file content to check that a cached parse is still valid.
+  std::string hash;
+  {
+  cmsys::ifstream fin(path, std::ios::in | std::ios::binary);
+  cmOStringStream contentStream;
+  contentStream << fin.rdbuf();
+  hash = cmListFileCacheHash(contentStream.str());
+  }
+
+  std::map<std::string, Entry>::iterator i =
+    this->Entries.insert(std::make_pair(std::string(path), Entry())).first;
+  Entry& entry = i->second;
+  if(entry.Valid && entry.Hash == hash)
+    {
+    ++this->Hits;
+    lf->Functions = entry.Functions;
+    this->ReadTime += cmSystemTools::GetTime() - start;
+    return true;
+    }
+
+  // Name the file with the entry key so that the file name referenced
+  // by the parsed arguments lives as long as the cache.
+  cmListFile parsed;
+  cmListFileParser parser(&parsed, mf, i->first.c_str());
+  bool ok = parser.ParseFile();
+
+  // Reuse the result only if parsing produced no diagnostics that
+  // would need to be reported again.
+  entry.Valid = ok && !parser.Warned;
+  if(entry.Valid)
+    {
+    entry.Hash = hash;
+    entry.Functions = parsed.Functions;
+    }
+  else
+    {
+    entry.Hash = "";
+    entry.Functions.clear();
+    }
+  lf->Functions.swap(parsed.Functions);
+  this->ReadTime += cmSystemTools::GetTime() - start;
+  return ok;
+}
+
 //----------------------------------------------------------------------------
 bool cmListFileParser::ParseFunction(const char* name, long line)
 {
@@ -405,6 +471,7 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
   else
     {
     this->Makefile->IssueMessage(cmake::AUTHOR_WARNING, m.str());
+    this->Warned = true;
     return true;
     }
 }
@@ -15,14 +15,6 @@
 #include "cmStandardIncludes.h"
 
 class cmLocalGenerator;
-
-/** \class cmListFileCache
- * \brief A class to cache list file contents.
- *
- * cmListFileCache is a class used to cache the contents of parsed
- * cmake list files.
- */
-
 class cmMakefile;
 
 struct cmListFileArgument
@@ -97,6 +89,45 @@ struct cmListFile
   std::vector<cmListFileFunction> Functions;
 };
 
+/** \class cmListFileCache
+ * \brief A class to cache list file contents.
+ *
+ * cmListFileCache is a class used to cache the contents of parsed
+ * cmake list files.  A file read again during the same run, such as a
+ * module included from many directories, is not lexed again as long as
+ * its content has not changed.
+ */
+class cmListFileCache
+{
+public:
+  cmListFileCache(): Reads(0), Hits(0), ReadTime(0) {}
+
+  /** Fill the functions of the given list file from the file at the
+      given path.  Returns false on a parse error.  */
+  bool Parse(cmListFile* lf, const char* path, cmMakefile* mf);
+
+  /** Get the number of files parsed so far and how many of them
+      were satisfied from the cache.  */
+  unsigned long GetReads() const { return this->Reads; }
+  unsigned long GetHits() const { return this->Hits; }
+
+  /** Get the total time in seconds spent reading and parsing files.  */
+  double GetReadTime() const { return this->ReadTime; }
+
+private:
+  struct Entry
+  {
+    Entry(): Valid(false) {}
+    bool Valid;
+    std::string Hash;
+    std::vector<cmListFileFunction> Functions;
+  };
+  std::map<std::string, Entry> Entries;
+  unsigned long Reads;
+  unsigned long Hits;
+  double ReadTime;
+};
+
 struct cmValueWithOrigin {
   cmValueWithOrigin(const std::string &value,
                           const cmListFileBacktrace &bt)
@@ -406,7 +406,8 @@ void cmLocalNinjaGenerator::AppendCustomCommandLines(
 
 void
 cmLocalNinjaGenerator::WriteCustomCommandBuildStatement(
-  cmCustomCommand const *cc, const cmNinjaDeps& orderOnlyDeps)
+  cmCustomCommand const *cc, const cmNinjaDeps& orderOnlyDeps,
+  const std::string& pool)
 {
   if (this->GetGlobalNinjaGenerator()->SeenCustomCommand(cc))
     return;
@@ -444,7 +445,8 @@ cmLocalNinjaGenerator::WriteCustomCommandBuildStatement(
       "Custom command for " + ninjaOutputs[0],
       ninjaOutputs,
       ninjaDeps,
-      orderOnlyDeps);
+      orderOnlyDeps,
+      pool);
   }
 }
 
@@ -484,7 +486,20 @@ void cmLocalNinjaGenerator::WriteCustomCommandBuildStatements()
       ccTargetDeps = depsIntersection;
     }
 
-    this->WriteCustomCommandBuildStatement(i->first, ccTargetDeps);
+    // Run the command in the JOB_POOL_CUSTOM pool of the target using it,
+    // or of the first one by name if several targets set one.
+    std::string pool;
+    std::string poolTarget;
+    for (j = i->second.begin(); j != i->second.end(); ++j) {
+      const char* jPool = (*j)->GetProperty("JOB_POOL_CUSTOM");
+      if (jPool && *jPool &&
+          (poolTarget.empty() || (*j)->GetName() < poolTarget)) {
+        pool = jPool;
+        poolTarget = (*j)->GetName();
+      }
+    }
+
+    this->WriteCustomCommandBuildStatement(i->first, ccTargetDeps, pool);
   }
 }
 
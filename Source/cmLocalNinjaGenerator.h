@@ -125,7 +125,8 @@ private:
 
   void WriteCustomCommandRule();
   void WriteCustomCommandBuildStatement(cmCustomCommand const *cc,
-                                        const cmNinjaDeps& orderOnlyDeps);
+                                        const cmNinjaDeps& orderOnlyDeps,
+                                        const std::string& pool);
 
   void WriteCustomCommandBuildStatements();
 
@@ -143,10 +143,16 @@ void cmLocalUnixMakefileGenerator3::Generate()
   this->SkipAssemblySourceRules =
     this->Makefile->IsOn("CMAKE_SKIP_ASSEMBLY_SOURCE_RULES");
 
-  // Generate the rule files for each target.
-  cmGeneratorTargetsType targets = this->Makefile->GetGeneratorTargets();
+  // Keep the files generated by the previous run if still up to date.
   cmGlobalUnixMakefileGenerator3* gg =
     static_cast<cmGlobalUnixMakefileGenerator3*>(this->GlobalGenerator);
+  if(gg->ReuseGeneratedFiles(this))
+    {
+    return;
+    }
+
+  // Generate the rule files for each target.
+  cmGeneratorTargetsType targets = this->Makefile->GetGeneratorTargets();
   for(cmGeneratorTargetsType::iterator t = targets.begin();
       t != targets.end(); ++t)
     {
@@ -30,6 +30,7 @@
 #include "cmInstallGenerator.h"
 #include "cmTestGenerator.h"
 #include "cmDefinitions.h"
+#include "cmProfiler.h"
 #include "cmake.h"
 #include <stdlib.h> // required for atoi
 
@@ -104,6 +105,8 @@ cmMakefile::cmMakefile(): Internal(new Internals)
 
   this->NumLastMatches = 0;
   this->SuppressWatches = false;
+  this->SourceLookupCount = 0;
+  this->SourceLookupFullPathCount = 0;
 }
 
 cmMakefile::cmMakefile(const cmMakefile& mf): Internal(new Internals)
@@ -122,6 +125,8 @@ cmMakefile::cmMakefile(const cmMakefile& mf): Internal(new Internals)
   this->ProjectName = mf.ProjectName;
   this->Targets = mf.Targets;
   this->SourceFiles = mf.SourceFiles;
+  this->SourceNameIndex = mf.SourceNameIndex;
+  this->SourceFullPathIndex = mf.SourceFullPathIndex;
   this->Tests = mf.Tests;
   this->LinkDirectories = mf.LinkDirectories;
   this->SystemIncludeDirectories = mf.SystemIncludeDirectories;
@@ -155,6 +160,8 @@ cmMakefile::cmMakefile(const cmMakefile& mf): Internal(new Internals)
 
   this->NumLastMatches = mf.NumLastMatches;
   this->SuppressWatches = mf.SuppressWatches;
+  this->SourceLookupCount = 0;
+  this->SourceLookupFullPathCount = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -401,6 +408,24 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
     cmsys::auto_ptr<cmCommand> pcmd(proto->Clone());
     pcmd->SetMakefile(this);
 
+    // Time user-defined functions and macros under their own category.
+    cmProfiler* profiler = this->GetCMakeInstance()->GetProfiler();
+    const char* category = "command";
+    std::string profileName;
+    if(profiler)
+      {
+      profileName = cmSystemTools::LowerCase(name);
+      if(pcmd->IsA("cmFunctionHelperCommand"))
+        {
+        category = "function";
+        }
+      else if(pcmd->IsA("cmMacroHelperCommand"))
+        {
+        category = "macro";
+        }
+      }
+    cmProfilerScope profile(profiler, category, profileName, &lff);
+
     // Decide whether to invoke the command.
     if(pcmd->GetEnabled() && !cmSystemTools::GetFatalErrorOccured()  &&
        (this->GetCMakeInstance()->GetWorkingMode() != cmake::SCRIPT_MODE
@@ -663,6 +688,8 @@ bool cmMakefile::ReadListFile(const char* filename_in,
     {
     *fullPath=filenametoread;
     }
+  cmProfilerScope profile(this->GetCMakeInstance()->GetProfiler(),
+                          "file", filenametoread);
   cmListFile cacheFile;
   if( !cacheFile.ParseFile(filenametoread, requireProjectCommand, this) )
     {
@@ -1379,7 +1406,10 @@ void cmMakefile::AddCompileOption(const char* option)
 
 bool cmMakefile::ParseDefineFlag(std::string const& def, bool remove)
 {
-  // Create a regular expression to match valid definitions.
+  // Create a regular expression to match valid definitions.  This and
+  // the expression below are shared by all calls and keep the state of
+  // their last match, so they are only used for a yes/no answer right
+  // away and must not be used from more than one thread.
   static cmsys::RegularExpression
     valid("^[-/]D[A-Za-z_][A-Za-z0-9_]*(=.*)?$");
 
@@ -2514,6 +2544,12 @@ std::vector<std::string> cmMakefile
   return res;
 }
 
+//----------------------------------------------------------------------------
+void cmMakefile::WriteDefinitionsState(std::ostream& os) const
+{
+  this->Internal->VarStack.top().WriteState(os);
+}
+
 
 const char *cmMakefile::ExpandVariablesInString(std::string& source) const
 {
@@ -3483,19 +3519,93 @@ void cmMakefile::SetArgcArgv(const std::vector<std::string>& args)
 cmSourceFile* cmMakefile::GetSource(const std::string& sourceName) const
 {
   cmSourceFileLocation sfl(this, sourceName);
-  for(std::vector<cmSourceFile*>::const_iterator
-        sfi = this->SourceFiles.begin();
-      sfi != this->SourceFiles.end(); ++sfi)
+  ++this->SourceLookupCount;
+
+  // A source file can match only if its name equals ours or if one of
+  // the two names is the other plus an extension.  Collect the sources
+  // indexed under our name and under our name without its extension.
+  std::vector<size_t> candidates;
+  std::string const& name = sfl.GetName();
+  std::string stem = cmSystemTools::GetFilenameWithoutLastExtension(name);
+  SourceIndexMap::const_iterator i = this->SourceNameIndex.find(name);
+  if(i != this->SourceNameIndex.end())
+    {
+    candidates = i->second;
+    }
+  if(stem != name)
+    {
+    i = this->SourceNameIndex.find(stem);
+    if(i != this->SourceNameIndex.end())
+      {
+      candidates.insert(candidates.end(),
+                        i->second.begin(), i->second.end());
+      std::sort(candidates.begin(), candidates.end());
+      }
+    }
+
+  // A source file whose location was fully known on creation is the
+  // answer unless an earlier source file also matches.
+  size_t end = this->SourceFiles.size();
+  if(!sfl.DirectoryIsAmbiguous() && !sfl.ExtensionIsAmbiguous())
     {
-    cmSourceFile* sf = *sfi;
+    std::string fullPath = sfl.GetDirectory();
+    fullPath += "/";
+    fullPath += name;
+    SourceFullPathMap::const_iterator fp =
+      this->SourceFullPathIndex.find(fullPath);
+    if(fp != this->SourceFullPathIndex.end())
+      {
+      end = fp->second;
+      }
+    }
+
+  // Try candidates in creation order to match the first source file
+  // that a scan over all of them would find.
+  size_t last = end;
+  for(std::vector<size_t>::const_iterator ci = candidates.begin();
+      ci != candidates.end() && *ci < end; ++ci)
+    {
+    if(*ci == last)
+      {
+      continue;
+      }
+    last = *ci;
+    cmSourceFile* sf = this->SourceFiles[*ci];
     if(sf->Matches(sfl))
       {
       return sf;
       }
     }
+  if(end != this->SourceFiles.size())
+    {
+    ++this->SourceLookupFullPathCount;
+    return this->SourceFiles[end];
+    }
   return 0;
 }
 
+//----------------------------------------------------------------------------
+void cmMakefile::AddSourceToIndex(cmSourceFile* sf, size_t pos)
+{
+  cmSourceFileLocation const& loc = sf->GetLocation();
+  std::string const& name = loc.GetName();
+  this->SourceNameIndex[name].push_back(pos);
+  std::string stem = cmSystemTools::GetFilenameWithoutLastExtension(name);
+  if(stem != name)
+    {
+    this->SourceNameIndex[stem].push_back(pos);
+    }
+  if(!loc.DirectoryIsAmbiguous() && !loc.ExtensionIsAmbiguous())
+    {
+    std::string fullPath = loc.GetDirectory();
+    fullPath += "/";
+    fullPath += name;
+    // Keep the first source file created with this full path.
+    this->SourceFullPathIndex.insert(
+      SourceFullPathMap::value_type(fullPath, pos));
+    }
+}
+
 //----------------------------------------------------------------------------
 cmSourceFile* cmMakefile::CreateSource(const std::string& sourceName,
                                        bool generated)
@@ -3506,6 +3616,7 @@ cmSourceFile* cmMakefile::CreateSource(const std::string& sourceName,
     sf->SetProperty("GENERATED", "1");
     }
   this->SourceFiles.push_back(sf);
+  this->AddSourceToIndex(sf, this->SourceFiles.size() - 1);
   return sf;
 }
 
@@ -3648,6 +3759,10 @@ int cmMakefile::TryCompile(const std::string& srcdir,
     cm.AddCacheEntry("CMAKE_SUPPRESS_DEVELOPER_WARNINGS",
                      "FALSE", "", cmCacheManager::INTERNAL);
     }
+  cmProfiler* profiler = this->GetCMakeInstance()->GetProfiler();
+  {
+  cmProfilerScope profile(profiler, "try_compile",
+                          "Generate " + projectName);
   if (cm.Configure() != 0)
     {
     cmSystemTools::Error(
@@ -3667,15 +3782,20 @@ int cmMakefile::TryCompile(const std::string& srcdir,
     this->Internal->IsSourceFileTryCompile = false;
     return 1;
     }
+  }
 
   // finally call the generator to actually build the resulting project
-  int ret =
+  int ret;
+  {
+  cmProfilerScope profile(profiler, "try_compile", "Build " + projectName);
+  ret =
     this->LocalGenerator->GetGlobalGenerator()->TryCompile(srcdir,bindir,
                                                            projectName,
                                                            targetName,
                                                            fast,
                                                            output,
                                                            this);
+  }
 
   cmSystemTools::ChangeDirectory(cwd.c_str());
   this->Internal->IsSourceFileTryCompile = false;
@@ -604,6 +604,15 @@ public:
   cmSourceFile* GetOrCreateSource(const std::string& sourceName,
                                   bool generated = false);
 
+  /**
+   * Get the number of GetSource lookups performed so far and how many
+   * of them were answered directly by the full path index.
+   */
+  unsigned long GetSourceLookupCount() const
+    { return this->SourceLookupCount; }
+  unsigned long GetSourceLookupFullPathCount() const
+    { return this->SourceLookupFullPathCount; }
+
   /**
    * Obtain a list of auxiliary source directories.
    */
@@ -637,6 +646,12 @@ public:
    */
   std::vector<std::string> GetDefinitions(int cacheonly=0) const;
 
+  /**
+   * Write the variables of the current scope, not including cache
+   * entries, and their values to a stream in a stable order.
+   */
+  void WriteDefinitionsState(std::ostream& os) const;
+
   /**
    * Test a boolean variable to see if it is true or false.
    * If the variable is not found in this makefile instance, the
@@ -974,6 +989,25 @@ protected:
   cmGeneratorTargetsType GeneratorTargets;
   std::vector<cmSourceFile*> SourceFiles;
 
+  // Indexes for fast source file look up.  Both map to positions in
+  // SourceFiles so that candidates can be tried in creation order.
+  // The name index holds each source under its file name and under its
+  // name without the last extension so that a name whose extension is
+  // ambiguous still finds its candidates.  The full path index holds
+  // only sources whose directory and extension are known on creation.
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  typedef cmsys::hash_map<std::string, std::vector<size_t> > SourceIndexMap;
+  typedef cmsys::hash_map<std::string, size_t> SourceFullPathMap;
+#else
+  typedef std::map<std::string, std::vector<size_t> > SourceIndexMap;
+  typedef std::map<std::string, size_t> SourceFullPathMap;
+#endif
+  SourceIndexMap SourceNameIndex;
+  SourceFullPathMap SourceFullPathIndex;
+  void AddSourceToIndex(cmSourceFile* sf, size_t pos);
+  mutable unsigned long SourceLookupCount;
+  mutable unsigned long SourceLookupFullPathCount;
+
   // Tests
   std::map<std::string, cmTest*> Tests;
 
@@ -64,7 +64,8 @@ cmNinjaTargetGenerator::cmNinjaTargetGenerator(cmTarget* target)
     Makefile(target->GetMakefile()),
     LocalGenerator(
       static_cast<cmLocalNinjaGenerator*>(Makefile->GetLocalGenerator())),
-    Objects()
+    Objects(),
+    TargetDefinesComputed(false)
 {
   this->GeneratorTarget =
     this->GetGlobalGenerator()->GetGeneratorTarget(target);
@@ -219,27 +220,44 @@ std::string
 cmNinjaTargetGenerator::
 ComputeDefines(cmSourceFile const* source, const std::string& language)
 {
-  std::set<std::string> defines;
-
-  // Add the export symbol definition for shared library objects.
-  if(const char* exportMacro = this->Target->GetExportMacro())
+  if(!this->TargetDefinesComputed)
     {
-    this->LocalGenerator->AppendDefines(defines, exportMacro);
+    // Add the export symbol definition for shared library objects.
+    if(const char* exportMacro = this->Target->GetExportMacro())
+      {
+      this->LocalGenerator->AppendDefines(this->TargetDefines, exportMacro);
+      }
+
+    // Add preprocessor definitions for this target and configuration.
+    this->LocalGenerator->AddCompileDefinitions(this->TargetDefines,
+                                                this->Target,
+                                                this->GetConfigName());
+    this->TargetDefinesComputed = true;
     }
 
-  // Add preprocessor definitions for this target and configuration.
-  this->LocalGenerator->AddCompileDefinitions(defines, this->Target,
-                                             this->GetConfigName());
-  this->LocalGenerator->AppendDefines
-    (defines,
-     source->GetProperty("COMPILE_DEFINITIONS"));
-  {
+  const char* sourceDefines = source->GetProperty("COMPILE_DEFINITIONS");
   std::string defPropName = "COMPILE_DEFINITIONS_";
   defPropName += cmSystemTools::UpperCase(this->GetConfigName());
-  this->LocalGenerator->AppendDefines
-    (defines,
-     source->GetProperty(defPropName));
-  }
+  const char* sourceConfigDefines = source->GetProperty(defPropName);
+
+  // Most sources have no definitions of their own and share the string.
+  if(!sourceDefines && !sourceConfigDefines)
+    {
+    LanguageFlagMap::iterator i = this->LanguageDefines.find(language);
+    if(i == this->LanguageDefines.end())
+      {
+      std::string definesString;
+      this->LocalGenerator->JoinDefines(this->TargetDefines, definesString,
+                                        language);
+      i = this->LanguageDefines.insert(
+        std::make_pair(language, definesString)).first;
+      }
+    return i->second;
+    }
+
+  std::set<std::string> defines = this->TargetDefines;
+  this->LocalGenerator->AppendDefines(defines, sourceDefines);
+  this->LocalGenerator->AppendDefines(defines, sourceConfigDefines);
 
   std::string definesString;
   this->LocalGenerator->JoinDefines(defines, definesString,
@@ -686,6 +704,13 @@ cmNinjaTargetGenerator
                                                      sourceFileName);
     }
 
+  // Objects of a target, and often of many targets, are compiled with
+  // the same flags, so write each distinct value only once.
+  vars["FLAGS"] = this->GetGlobalGenerator()->ShareVariable(
+    this->GetBuildFileStream(), "FLAGS", vars["FLAGS"]);
+  vars["DEFINES"] = this->GetGlobalGenerator()->ShareVariable(
+    this->GetBuildFileStream(), "DEFINES", vars["DEFINES"]);
+
   this->GetGlobalGenerator()->WriteBuild(this->GetBuildFileStream(),
                                          comment,
                                          rule,
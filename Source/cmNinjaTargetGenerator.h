@@ -163,6 +163,12 @@ private:
   typedef std::map<std::string, std::string> LanguageFlagMap;
   LanguageFlagMap LanguageFlags;
 
+  // Definitions of the whole target, and the same joined per language
+  // for the sources that add none of their own.
+  bool TargetDefinesComputed;
+  std::set<std::string> TargetDefines;
+  LanguageFlagMap LanguageDefines;
+
   // The windows module definition source file (.def), if any.
   std::string ModuleDefinitionFile;
 };
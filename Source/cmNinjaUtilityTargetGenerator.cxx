@@ -106,12 +106,16 @@ void cmNinjaUtilityTargetGenerator::Generate()
     std::string utilCommandName = cmake::GetCMakeFilesDirectoryPostSlash();
     utilCommandName += this->GetTargetName() + ".util";
 
+    const char* pool = this->GetTarget()->GetProperty("JOB_POOL_CUSTOM");
+
     this->GetGlobalGenerator()->WriteCustomCommandBuild(
       command,
       desc,
       "Utility command for " + this->GetTargetName(),
       cmNinjaDeps(1, utilCommandName),
-      deps);
+      deps,
+      cmNinjaDeps(),
+      pool ? pool : "");
 
     this->GetGlobalGenerator()->WritePhonyBuild(this->GetBuildFileStream(),
                                                 "",
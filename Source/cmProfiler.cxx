@@ -0,0 +1,237 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2014 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmProfiler.h"
+
+#include "cmGeneratedFileStream.h"
+#include "cmGlobalGenerator.h"
+#include "cmListFileCache.h"
+#include "cmSystemTools.h"
+
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+cmProfiler::cmProfiler(std::string const& file): File(file)
+{
+  this->StartTime = cmSystemTools::GetTime();
+}
+
+//----------------------------------------------------------------------------
+int cmProfiler::CurrentFrame() const
+{
+  return this->Stack.empty()? -1 : this->Events[this->Stack.back()].Frame;
+}
+
+//----------------------------------------------------------------------------
+void cmProfiler::Begin(const char* category, std::string const& name,
+                       cmListFileContext const* context)
+{
+  EntryMap::iterator i =
+    this->Entries.find(std::make_pair(std::string(category), name));
+  if(i == this->Entries.end())
+    {
+    Entry e;
+    e.Name = name;
+    e.Category = category;
+    e.Count = 0;
+    e.Inclusive = 0;
+    e.Exclusive = 0;
+    e.Active = 0;
+    i = this->Entries.insert(
+      std::make_pair(std::make_pair(std::string(category), name), e)).first;
+    }
+  ++i->second.Count;
+  ++i->second.Active;
+
+  Event ev;
+  ev.E = &i->second;
+  ev.Duration = 0;
+  ev.Children = 0;
+  ev.Frame = this->CurrentFrame();
+  if(context)
+    {
+    cmOStringStream frame;
+    frame << context->Name << " " << context->FilePath << ":"
+          << context->Line;
+    std::pair<int, std::string> key(ev.Frame, frame.str());
+    std::map<std::pair<int, std::string>, int>::iterator f =
+      this->FrameIndex.find(key);
+    if(f == this->FrameIndex.end())
+      {
+      Frame fr;
+      fr.Parent = ev.Frame;
+      fr.Name = key.second;
+      f = this->FrameIndex.insert(
+        std::make_pair(key, static_cast<int>(this->Frames.size()))).first;
+      this->Frames.push_back(fr);
+      }
+    ev.Frame = f->second;
+    }
+  this->Stack.push_back(this->Events.size());
+  ev.Start = cmSystemTools::GetTime();
+  this->Events.push_back(ev);
+}
+
+//----------------------------------------------------------------------------
+void cmProfiler::End()
+{
+  double now = cmSystemTools::GetTime();
+  if(this->Stack.empty())
+    {
+    return;
+    }
+  Event& ev = this->Events[this->Stack.back()];
+  this->Stack.pop_back();
+  ev.Duration = now - ev.Start;
+  ev.E->Exclusive += ev.Duration - ev.Children;
+  if(--ev.E->Active == 0)
+    {
+    ev.E->Inclusive += ev.Duration;
+    }
+  if(!this->Stack.empty())
+    {
+    this->Events[this->Stack.back()].Children += ev.Duration;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmProfiler::Write()
+{
+  // Close anything left open by an early exit.
+  while(!this->Stack.empty())
+    {
+    this->End();
+    }
+
+  cmGeneratedFileStream fout(this->File.c_str());
+  if(!fout)
+    {
+    cmSystemTools::Error("Could not open profile file ",
+                         this->File.c_str());
+    return false;
+    }
+  fout << "{\n\"traceEvents\": [\n";
+  std::string line;
+  char buf[64];
+  for(std::vector<Event>::const_iterator ei = this->Events.begin();
+      ei != this->Events.end(); ++ei)
+    {
+    line = ei == this->Events.begin()? "{\"name\": \"" : ",\n{\"name\": \"";
+    cmGlobalGenerator::AppendEscapedJSON(line, ei->E->Name);
+    line += "\", \"cat\": \"";
+    line += ei->E->Category;
+    // Chrome expects microseconds.
+    sprintf(buf, "\", \"ph\": \"X\", \"ts\": %.0f, \"dur\": %.0f",
+            (ei->Start - this->StartTime) * 1e6, ei->Duration * 1e6);
+    line += buf;
+    line += ", \"pid\": 1, \"tid\": 1";
+    if(ei->Frame >= 0)
+      {
+      sprintf(buf, ", \"sf\": \"%d\"", ei->Frame);
+      line += buf;
+      }
+    line += "}";
+    fout << line;
+    }
+  fout << "\n],\n\"stackFrames\": {\n";
+  for(size_t f = 0; f < this->Frames.size(); ++f)
+    {
+    sprintf(buf, "%s\"%d\": {\"name\": \"", f? ",\n" : "",
+            static_cast<int>(f));
+    line = buf;
+    cmGlobalGenerator::AppendEscapedJSON(line, this->Frames[f].Name);
+    line += "\"";
+    if(this->Frames[f].Parent >= 0)
+      {
+      sprintf(buf, ", \"parent\": \"%d\"", this->Frames[f].Parent);
+      line += buf;
+      }
+    line += "}";
+    fout << line;
+    }
+  fout << "\n},\n\"displayTimeUnit\": \"ms\"\n}\n";
+  if(!fout.Close())
+    {
+    cmSystemTools::Error("Could not write profile file ",
+                         this->File.c_str());
+    return false;
+    }
+
+  std::cout << "-- Profile written to: " << this->File << "\n";
+  this->WriteSummary("commands by inclusive time", false, false);
+  this->WriteSummary("commands by exclusive time", false, true);
+  this->WriteSummary("list files by inclusive time", true, false);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+namespace
+{
+  struct cmProfilerEntryLess
+  {
+    cmProfilerEntryLess(bool exclusive): Exclusive(exclusive) {}
+    template <typename T>
+    bool operator()(T const* l, T const* r) const
+      {
+      double lt = this->Exclusive? l->Exclusive : l->Inclusive;
+      double rt = this->Exclusive? r->Exclusive : r->Inclusive;
+      if(lt != rt)
+        {
+        return lt > rt;
+        }
+      return l->Name < r->Name;
+      }
+    bool Exclusive;
+  };
+}
+
+//----------------------------------------------------------------------------
+void cmProfiler::WriteSummary(const char* title, bool files, bool exclusive)
+{
+  std::vector<Entry const*> entries;
+  for(EntryMap::const_iterator i = this->Entries.begin();
+      i != this->Entries.end(); ++i)
+    {
+    std::string const& cat = i->first.first;
+    bool isFile = cat == "file";
+    bool isCommand =
+      cat == "command" || cat == "function" || cat == "macro";
+    if(files? isFile : isCommand)
+      {
+      entries.push_back(&i->second);
+      }
+    }
+  if(entries.empty())
+    {
+    return;
+    }
+  std::sort(entries.begin(), entries.end(), cmProfilerEntryLess(exclusive));
+  if(entries.size() > 20)
+    {
+    entries.resize(20);
+    }
+
+  std::cout << "-- Top " << title << ":\n"
+            << "   inclusive  exclusive     calls  name\n";
+  char buf[64];
+  for(std::vector<Entry const*>::const_iterator i = entries.begin();
+      i != entries.end(); ++i)
+    {
+    sprintf(buf, "   %8.3fs  %8.3fs  %8lu  ", (*i)->Inclusive,
+            (*i)->Exclusive, (*i)->Count);
+    std::cout << buf << (*i)->Name;
+    if(!files && strcmp((*i)->Category, "command") != 0)
+      {
+      std::cout << " (" << (*i)->Category << ")";
+      }
+    std::cout << "\n";
+    }
+}
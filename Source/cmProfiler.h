@@ -0,0 +1,114 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2014 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmProfiler_h
+#define cmProfiler_h
+
+#include "cmStandardIncludes.h"
+
+struct cmListFileContext;
+
+/** \class cmProfiler
+ * \brief Record where time goes while configuring and generating.
+ *
+ * Enabled by "cmake --profile=<file>".  Nested events are recorded as
+ * commands, list files and generate steps run.  Write() stores them in
+ * the Chrome trace event format, which chrome://tracing and similar
+ * viewers load, and prints the commands and list files that took the
+ * most time.  Each command event refers to a stack frame whose parents
+ * are the commands that called it, so the viewer shows its backtrace.
+ */
+class cmProfiler
+{
+public:
+  cmProfiler(std::string const& file);
+
+  /** Start an event nested in the current one.  Commands give the
+      context they were called from.  */
+  void Begin(const char* category, std::string const& name,
+             cmListFileContext const* context = 0);
+
+  /** End the innermost event.  */
+  void End();
+
+  /** Write the trace file and print the summary.  */
+  bool Write();
+
+private:
+  std::string File;
+  double StartTime;
+
+  // Totals for one name within one category.
+  struct Entry
+  {
+    std::string Name;
+    const char* Category;
+    unsigned long Count;
+    double Inclusive;
+    double Exclusive;
+    unsigned int Active;  // Nesting depth, to not count recursion twice.
+  };
+  typedef std::map<std::pair<std::string, std::string>, Entry> EntryMap;
+  EntryMap Entries;
+
+  struct Event
+  {
+    Entry* E;
+    double Start;
+    double Duration;
+    double Children;
+    int Frame;
+  };
+  std::vector<Event> Events;
+  std::vector<size_t> Stack;
+
+  // Call stack frames shared by all events, keyed by parent and name.
+  struct Frame
+  {
+    int Parent;
+    std::string Name;
+  };
+  std::vector<Frame> Frames;
+  std::map<std::pair<int, std::string>, int> FrameIndex;
+  int CurrentFrame() const;
+
+  void WriteSummary(const char* title, bool files, bool exclusive);
+};
+
+/** \class cmProfilerScope
+ * \brief Record an event for the lifetime of a scope.
+ *
+ * Does nothing when given a null profiler.
+ */
+class cmProfilerScope
+{
+public:
+  cmProfilerScope(cmProfiler* profiler, const char* category,
+                  std::string const& name,
+                  cmListFileContext const* context = 0): Profiler(profiler)
+    {
+    if(this->Profiler)
+      {
+      this->Profiler->Begin(category, name, context);
+      }
+    }
+  ~cmProfilerScope()
+    {
+    if(this->Profiler)
+      {
+      this->Profiler->End();
+      }
+    }
+private:
+  cmProfiler* Profiler;
+};
+
+#endif
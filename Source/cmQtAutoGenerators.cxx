@@ -22,6 +22,8 @@
 #endif
 
 #include <cmsys/Terminal.h>
+#include <cmsys/Process.h>
+#include <cmsys/SystemInformation.hxx>
 #include <cmsys/ios/sstream>
 #include <cmsys/FStream.hxx>
 #include <assert.h>
@@ -131,6 +133,7 @@ cmQtAutoGenerators::cmQtAutoGenerators()
 ,RunUicFailed(false)
 ,RunRccFailed(false)
 ,GenerateAll(false)
+,Parallel(1)
 {
 
   std::string colorEnv = "";
@@ -399,6 +402,8 @@ void cmQtAutoGenerators::SetupAutoGenerateTarget(cmTarget const* target)
     }
   makefile->AddDefinition("_cpp_files",
           cmLocalGenerator::EscapeForCMake(this->Sources).c_str());
+  const char* parallel = target->GetProperty("AUTOGEN_PARALLEL");
+  makefile->AddDefinition("_autogen_parallel", parallel ? parallel : "");
   if (target->GetPropertyAsBool("AUTOMOC"))
     {
     this->SetupAutoMocTarget(target, autogenTargetName,
@@ -1133,6 +1138,43 @@ bool cmQtAutoGenerators::ReadAutogenInfoFile(cmMakefile* makefile,
 
   this->RelaxedMode = makefile->IsOn("AM_RELAXED_MODE");
 
+  // Run one job at a time unless the AUTOGEN_PARALLEL target property
+  // gives a number, or is AUTO to use the number of jobs given to make,
+  // or else one job per processor.
+  std::string parallel = makefile->GetSafeDefinition("AM_PARALLEL");
+  long jobs = 1;
+  if (parallel == "AUTO")
+    {
+    jobs = 0;
+    std::string makeflags;
+    cmsys::SystemTools::GetEnv("MAKEFLAGS", makeflags);
+    std::vector<std::string> flags;
+    cmSystemTools::ParseUnixCommandLine(makeflags.c_str(), flags);
+    for (std::vector<std::string>::const_iterator fi = flags.begin();
+         fi != flags.end(); ++fi)
+      {
+      if (cmHasLiteralPrefix(*fi, "--jobs="))
+        {
+        jobs = atol(fi->c_str() + 7);
+        }
+      else if (cmHasLiteralPrefix(*fi, "-j"))
+        {
+        jobs = atol(fi->c_str() + 2);
+        }
+      }
+    if (jobs <= 0)
+      {
+      cmsys::SystemInformation info;
+      info.RunCPUCheck();
+      jobs = static_cast<long>(info.GetNumberOfLogicalCPU());
+      }
+    }
+  else if (!parallel.empty())
+    {
+    jobs = atol(parallel.c_str());
+    }
+  this->Parallel = jobs > 0 ? static_cast<unsigned int>(jobs) : 1;
+
   return true;
 }
 
@@ -1398,7 +1440,6 @@ bool cmQtAutoGenerators::RunAutogen(cmMakefile* makefile)
   cmsys_ios::stringstream outStream;
   outStream << "/* This file is autogenerated, do not edit*/\n";
 
-  bool automocCppChanged = false;
   if (notIncludedMocs.empty())
     {
     outStream << "enum some_compilers { need_more_than_nothing };\n";
@@ -1412,15 +1453,13 @@ bool cmQtAutoGenerators::RunAutogen(cmMakefile* makefile)
         it != notIncludedMocs.end();
         ++it)
       {
-      bool mocSuccess = this->GenerateMoc(it->first, it->second);
-      if (mocSuccess)
-        {
-        automocCppChanged = true;
-        }
+      this->GenerateMoc(it->first, it->second);
       outStream << "#include \"" << it->second << "\"\n";
       }
     }
 
+  this->RunJobs();
+
   if (this->RunMocFailed)
     {
     std::cerr << "moc failed..." << std::endl;
@@ -1439,15 +1478,13 @@ bool cmQtAutoGenerators::RunAutogen(cmMakefile* makefile)
     }
   outStream.flush();
   std::string automocSource = outStream.str();
-  if (!automocCppChanged)
+  // Leave the _automoc.cpp file alone if its content is the same.  The
+  // moc files it includes are dependencies of its object file, so they
+  // still cause a rebuild when they change.
+  const std::string oldContents = ReadAll(this->OutMocCppFilename);
+  if (oldContents == automocSource)
     {
-    // compare contents of the _automoc.cpp file
-    const std::string oldContents = ReadAll(this->OutMocCppFilename);
-    if (oldContents == automocSource)
-      {
-      // nothing changed: don't touch the _automoc.cpp file
-      return true;
-      }
+    return true;
     }
 
   // source file that includes all remaining moc files (_automoc.cpp file)
@@ -1960,16 +1997,9 @@ bool cmQtAutoGenerators::GenerateMoc(const std::string& sourceFile,
       std::cout << std::endl;
       }
 
-    std::string output;
-    int retVal = 0;
-    bool result = cmSystemTools::RunSingleCommand(command, &output, &retVal);
-    if (!result || retVal)
-      {
-      std::cerr << "AUTOGEN: error: process for " << mocFilePath <<" failed:\n"
-                << output << std::endl;
-      this->RunMocFailed = true;
-      cmSystemTools::RemoveFile(mocFilePath.c_str());
-      }
+    this->AddJob(command, mocFilePath,
+                 "AUTOGEN: error: process for " + mocFilePath + " failed:\n",
+                 &this->RunMocFailed);
     return true;
     }
   return false;
@@ -2034,17 +2064,9 @@ bool cmQtAutoGenerators::GenerateUi(const std::string& realName,
         }
       std::cout << std::endl;
       }
-    std::string output;
-    int retVal = 0;
-    bool result = cmSystemTools::RunSingleCommand(command, &output, &retVal);
-    if (!result || retVal)
-      {
-      std::cerr << "AUTOUIC: error: process for " << ui_output_file <<
-                " failed:\n" << output << std::endl;
-      this->RunUicFailed = true;
-      cmSystemTools::RemoveFile(ui_output_file.c_str());
-      return false;
-      }
+    this->AddJob(command, ui_output_file,
+                 "AUTOUIC: error: process for " + ui_output_file +
+                 " failed:\n", &this->RunUicFailed);
     return true;
     }
   return false;
@@ -2110,20 +2132,137 @@ bool cmQtAutoGenerators::GenerateQrc()
           }
         std::cout << std::endl;
         }
-      std::string output;
-      int retVal = 0;
-      bool result = cmSystemTools::RunSingleCommand(command, &output, &retVal);
-      if (!result || retVal)
+      this->AddJob(command, rcc_output_file,
+                   "AUTORCC: error: process for " + rcc_output_file +
+                   " failed:\n", &this->RunRccFailed);
+      }
+    }
+  return true;
+}
+
+void cmQtAutoGenerators::AddJob(const std::vector<std::string>& command,
+                                const std::string& outputFile,
+                                const std::string& errorPrefix,
+                                bool* failed)
+{
+  Job job;
+  job.Command = command;
+  job.OutputFile = outputFile;
+  job.ErrorPrefix = errorPrefix;
+  job.Failed = failed;
+  this->Jobs.push_back(job);
+}
+
+void cmQtAutoGenerators::RunJobs()
+{
+  // Each running job is a process and the index of its job.
+  typedef std::pair<cmsysProcess*, size_t> Running;
+  std::vector<Running> running;
+  std::vector<std::string> outputs(this->Jobs.size());
+  std::vector<bool> done(this->Jobs.size(), false);
+  std::vector<bool> failed(this->Jobs.size(), false);
+  size_t next = 0;
+  size_t reported = 0;
+  while(reported < this->Jobs.size())
+    {
+    // Start jobs until the limit is reached.
+    while(next < this->Jobs.size() && running.size() < this->Parallel)
+      {
+      std::vector<const char*> argv;
+      for(std::vector<std::string>::const_iterator
+            a = this->Jobs[next].Command.begin();
+          a != this->Jobs[next].Command.end(); ++a)
+        {
+        argv.push_back(a->c_str());
+        }
+      argv.push_back(0);
+      cmsysProcess* cp = cmsysProcess_New();
+      cmsysProcess_SetCommand(cp, &*argv.begin());
+      if(cmSystemTools::GetRunCommandHideConsole())
+        {
+        cmsysProcess_SetOption(cp, cmsysProcess_Option_HideWindow, 1);
+        }
+      cmsysProcess_Execute(cp);
+      running.push_back(Running(cp, next++));
+      }
+
+    // Wait until a job has output or has finished.
+    std::vector<cmsysProcess*> processes;
+    for(std::vector<Running>::const_iterator r = running.begin();
+        r != running.end(); ++r)
+      {
+      processes.push_back(r->first);
+      }
+    int ready = cmsysProcess_WaitForAny(&*processes.begin(),
+                                        static_cast<int>(processes.size()),
+                                        0);
+    if(ready < 0)
+      {
+      continue;
+      }
+
+    // Collect the output that is available.
+    cmsysProcess* cp = running[ready].first;
+    size_t index = running[ready].second;
+    std::string& output = outputs[index];
+    int pipe;
+    for(;;)
+      {
+      char* data;
+      int length;
+      double timeout = 0;
+      pipe = cmsysProcess_WaitForData(cp, &data, &length, &timeout);
+      if(pipe == cmsysProcess_Pipe_Timeout ||
+         pipe == cmsysProcess_Pipe_None)
+        {
+        break;
+        }
+      output.append(data, length);
+      }
+    if(pipe == cmsysProcess_Pipe_Timeout)
+      {
+      continue;
+      }
+
+    // The job has finished.
+    cmsysProcess_WaitForExit(cp, 0);
+    bool ok = false;
+    switch(cmsysProcess_GetState(cp))
+      {
+      case cmsysProcess_State_Exited:
+        ok = cmsysProcess_GetExitValue(cp) == 0;
+        break;
+      case cmsysProcess_State_Exception:
+        output += cmsysProcess_GetExceptionString(cp);
+        break;
+      case cmsysProcess_State_Error:
+        output += cmsysProcess_GetErrorString(cp);
+        break;
+      default:
+        break;
+      }
+    Job& job = this->Jobs[index];
+    if(!ok)
+      {
+      *job.Failed = true;
+      failed[index] = true;
+      cmSystemTools::RemoveFile(job.OutputFile.c_str());
+      }
+    done[index] = true;
+    cmsysProcess_Delete(cp);
+    running.erase(running.begin() + ready);
+
+    // Print the output of failed jobs in the order the jobs were added.
+    for(; reported < this->Jobs.size() && done[reported]; ++reported)
+      {
+      if(failed[reported])
         {
-        std::cerr << "AUTORCC: error: process for " << rcc_output_file <<
-                  " failed:\n" << output << std::endl;
-        this->RunRccFailed = true;
-        cmSystemTools::RemoveFile(rcc_output_file.c_str());
-        return false;
+        std::cerr << this->Jobs[reported].ErrorPrefix << outputs[reported]
+                  << std::endl;
         }
       }
     }
-  return true;
+  this->Jobs.clear();
 }
 
 std::string cmQtAutoGenerators::Join(const std::vector<std::string>& lst,
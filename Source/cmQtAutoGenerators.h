@@ -50,6 +50,10 @@ private:
                    const std::string& mocFileName);
   bool GenerateUi(const std::string& realName, const std::string& uiFileName);
   bool GenerateQrc();
+  void AddJob(const std::vector<std::string>& command,
+              const std::string& outputFile, const std::string& errorPrefix,
+              bool* failed);
+  void RunJobs();
   void ParseCppFile(const std::string& absFilename,
               const std::vector<std::string>& headerExtensions,
               std::map<std::string, std::string>& includedMocs,
@@ -125,6 +129,17 @@ private:
   bool GenerateAll;
   bool RelaxedMode;
 
+  // moc, uic and rcc commands run by RunJobs, at most Parallel at once.
+  struct Job
+  {
+    std::vector<std::string> Command;
+    std::string OutputFile;   // Removed when the command fails.
+    std::string ErrorPrefix;  // Printed before the output on failure.
+    bool* Failed;
+  };
+  std::vector<Job> Jobs;
+  unsigned int Parallel;
+
 };
 
 #endif
@@ -0,0 +1,50 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2014 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmRegularExpressionCache.h"
+
+// Number of compiled patterns to keep.
+#define CM_REGULAR_EXPRESSION_CACHE_SIZE 256
+
+//----------------------------------------------------------------------------
+cmsys::RegularExpression*
+cmRegularExpressionCache::Get(std::string const& pattern)
+{
+  ++this->Lookups;
+  std::map<std::string, EntryList::iterator>::iterator i =
+    this->Index.find(pattern);
+  if(i != this->Index.end())
+    {
+    ++this->Hits;
+    this->Entries.splice(this->Entries.begin(), this->Entries, i->second);
+    return &i->second->Regex;
+    }
+
+  // Compile the pattern in place.  Patterns that do not compile are
+  // not kept so that the error is reported every time.
+  this->Entries.push_front(Entry());
+  Entry& entry = this->Entries.front();
+  if(!entry.Regex.compile(pattern.c_str()))
+    {
+    this->Entries.pop_front();
+    return 0;
+    }
+  entry.Pattern = pattern;
+  this->Index[pattern] = this->Entries.begin();
+
+  // Drop the least recently used pattern.
+  if(this->Index.size() > CM_REGULAR_EXPRESSION_CACHE_SIZE)
+    {
+    this->Index.erase(this->Entries.back().Pattern);
+    this->Entries.pop_back();
+    }
+  return &entry.Regex;
+}
@@ -0,0 +1,61 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2014 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmRegularExpressionCache_h
+#define cmRegularExpressionCache_h
+
+#include "cmStandardIncludes.h"
+
+#include <cmsys/RegularExpression.hxx>
+
+#include <list>
+
+/** \class cmRegularExpressionCache
+ * \brief Keep recently compiled regular expressions for reuse.
+ *
+ * Commands taking a regular expression are often called in loops with
+ * the same pattern.  cmRegularExpressionCache keeps the most recently
+ * used patterns in compiled form so they are not compiled again.
+ */
+class cmRegularExpressionCache
+{
+public:
+  cmRegularExpressionCache(): Lookups(0), Hits(0) {}
+
+  /** Get the compiled form of the given pattern, or null if it does
+      not compile.  The result may be evicted by later calls, so use it
+      before looking up another pattern.  It is shared by all users of
+      the pattern and keeps the state of its last match, so copy any
+      subexpressions needed before running code that may match the same
+      pattern again.  The cache must not be used from more than one
+      thread.  */
+  cmsys::RegularExpression* Get(std::string const& pattern);
+
+  /** Get the number of patterns looked up so far and how many of them
+      were satisfied from the cache.  */
+  unsigned long GetLookups() const { return this->Lookups; }
+  unsigned long GetHits() const { return this->Hits; }
+
+private:
+  struct Entry
+  {
+    std::string Pattern;
+    cmsys::RegularExpression Regex;
+  };
+  // Most recently used first.
+  typedef std::list<Entry> EntryList;
+  EntryList Entries;
+  std::map<std::string, EntryList::iterator> Index;
+  unsigned long Lookups;
+  unsigned long Hits;
+};
+
+#endif
@@ -312,14 +312,17 @@ bool cmStringCommand::RegexMatch(std::vector<std::string> const& args)
 
   this->Makefile->ClearMatches();
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if(!re.compile(regex.c_str()))
+  cmsys::RegularExpression* rep =
+    this->Makefile->GetCMakeInstance()->GetRegularExpressionCache()
+    ->Get(regex);
+  if(!rep)
     {
     std::string e =
       "sub-command REGEX, mode MATCH failed to compile regex \""+regex+"\".";
     this->SetError(e);
     return false;
     }
+  cmsys::RegularExpression& re = *rep;
 
   // Scan through the input for all matches.
   std::string output;
@@ -361,8 +364,10 @@ bool cmStringCommand::RegexMatchAll(std::vector<std::string> const& args)
 
   this->Makefile->ClearMatches();
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if(!re.compile(regex.c_str()))
+  cmsys::RegularExpression* rep =
+    this->Makefile->GetCMakeInstance()->GetRegularExpressionCache()
+    ->Get(regex);
+  if(!rep)
     {
     std::string e =
       "sub-command REGEX, mode MATCHALL failed to compile regex \""+
@@ -370,6 +375,7 @@ bool cmStringCommand::RegexMatchAll(std::vector<std::string> const& args)
     this->SetError(e);
     return false;
     }
+  cmsys::RegularExpression& re = *rep;
 
   // Scan through the input for all matches.
   std::string output;
@@ -465,8 +471,10 @@ bool cmStringCommand::RegexReplace(std::vector<std::string> const& args)
 
   this->Makefile->ClearMatches();
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if(!re.compile(regex.c_str()))
+  cmsys::RegularExpression* rep =
+    this->Makefile->GetCMakeInstance()->GetRegularExpressionCache()
+    ->Get(regex);
+  if(!rep)
     {
     std::string e =
       "sub-command REGEX, mode REPLACE failed to compile regex \""+
@@ -474,6 +482,7 @@ bool cmStringCommand::RegexReplace(std::vector<std::string> const& args)
     this->SetError(e);
     return false;
     }
+  cmsys::RegularExpression& re = *rep;
 
   // Scan through the input for all matches.
   std::string output;
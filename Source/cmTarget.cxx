@@ -345,6 +345,7 @@ void cmTarget::SetMakefile(cmMakefile* mf)
     this->SetPropertyDefault("AUTOMOC_MOC_OPTIONS", 0);
     this->SetPropertyDefault("AUTOUIC_OPTIONS", 0);
     this->SetPropertyDefault("AUTORCC_OPTIONS", 0);
+    this->SetPropertyDefault("AUTOGEN_PARALLEL", 0);
     this->SetPropertyDefault("LINK_DEPENDS_NO_SHARED", 0);
     this->SetPropertyDefault("LINK_INTERFACE_LIBRARIES", 0);
     this->SetPropertyDefault("WIN32_EXECUTABLE", 0);
@@ -478,10 +479,14 @@ void cmTarget::SetMakefile(cmMakefile* mf)
     this->PolicyStatusCMP0022 = cmPolicies::NEW;
     }
 
-  if (this->GetType() != INTERFACE_LIBRARY && this->GetType() != UTILITY)
+  if (this->GetType() != INTERFACE_LIBRARY)
     {
-    this->SetPropertyDefault("JOB_POOL_COMPILE", 0);
-    this->SetPropertyDefault("JOB_POOL_LINK", 0);
+    if (this->GetType() != UTILITY)
+      {
+      this->SetPropertyDefault("JOB_POOL_COMPILE", 0);
+      this->SetPropertyDefault("JOB_POOL_LINK", 0);
+      }
+    this->SetPropertyDefault("JOB_POOL_CUSTOM", 0);
     }
 }
 
@@ -3217,6 +3222,97 @@ bool cmTarget::GetPropertyAsBool(const std::string& prop) const
   return cmSystemTools::IsOn(this->GetProperty(prop));
 }
 
+//----------------------------------------------------------------------------
+static void cmTargetWriteEntriesState(std::ostream& os,
+  std::vector<cmTargetInternals::TargetPropertyEntry*> const& entries)
+{
+  os << entries.size() << '\0';
+  for(std::vector<cmTargetInternals::TargetPropertyEntry*>::const_iterator
+        i = entries.begin(); i != entries.end(); ++i)
+    {
+    os << (*i)->ge->GetInput() << '\0';
+    }
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+static void cmTargetWriteListState(std::ostream& os, T const& values)
+{
+  os << values.size() << '\0';
+  for(typename T::const_iterator i = values.begin(); i != values.end(); ++i)
+    {
+    os << *i << '\0';
+    }
+}
+
+//----------------------------------------------------------------------------
+static void cmTargetWriteCommandsState(std::ostream& os,
+  std::vector<cmCustomCommand> const& commands)
+{
+  os << commands.size() << '\0';
+  for(std::vector<cmCustomCommand>::const_iterator i = commands.begin();
+      i != commands.end(); ++i)
+    {
+    i->WriteState(os);
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmTarget::WriteState(std::ostream& os) const
+{
+  // Terminate each value with a character it cannot contain and
+  // prefix each list with its size so that distinct targets never
+  // write the same text.
+  os << this->Name << '\0' << this->TargetTypeValue << '\0'
+     << this->IsImportedTarget << this->HaveInstallRule
+     << this->RecordDependencies << '\0'
+     << this->InstallPath << '\0' << this->RuntimeInstallPath << '\0';
+
+#define TARGET_POLICY_STATE(POLICY) \
+  os << this->PolicyStatus ## POLICY << ' ';
+
+  CM_FOR_EACH_TARGET_POLICY(TARGET_POLICY_STATE)
+
+#undef TARGET_POLICY_STATE
+  os << '\0';
+
+  os << this->Properties.size() << '\0';
+  for(cmPropertyMap::const_iterator i = this->Properties.begin();
+      i != this->Properties.end(); ++i)
+    {
+    const char* value = i->second.GetValue();
+    os << i->first << '\0' << (value? value : "") << '\0';
+    }
+
+  cmTargetWriteEntriesState(os, this->Internal->IncludeDirectoriesEntries);
+  cmTargetWriteEntriesState(os, this->Internal->CompileOptionsEntries);
+  cmTargetWriteEntriesState(os, this->Internal->CompileFeaturesEntries);
+  cmTargetWriteEntriesState(os, this->Internal->CompileDefinitionsEntries);
+  cmTargetWriteEntriesState(os, this->Internal->SourceEntries);
+  os << this->Internal->LinkImplementationPropertyEntries.size() << '\0';
+  for(std::vector<cmValueWithOrigin>::const_iterator
+        i = this->Internal->LinkImplementationPropertyEntries.begin();
+      i != this->Internal->LinkImplementationPropertyEntries.end(); ++i)
+    {
+    os << i->Value << '\0';
+    }
+
+  os << this->OriginalLinkLibraries.size() << '\0';
+  for(LinkLibraryVectorType::const_iterator
+        i = this->OriginalLinkLibraries.begin();
+      i != this->OriginalLinkLibraries.end(); ++i)
+    {
+    os << i->first << '\0' << i->second << '\0';
+    }
+  cmTargetWriteListState(os, this->LinkDirectories);
+  cmTargetWriteListState(os, this->Utilities);
+  cmTargetWriteListState(os, this->SystemIncludeDirectories);
+
+  cmTargetWriteCommandsState(os, this->PreBuildCommands);
+  cmTargetWriteCommandsState(os, this->PreLinkCommands);
+  cmTargetWriteCommandsState(os, this->PostBuildCommands);
+}
+
 //----------------------------------------------------------------------------
 class cmTargetCollectLinkLanguages
 {
@@ -3450,7 +3546,9 @@ void cmTarget::ExpandLinkItems(std::string const& prop,
                                std::vector<cmLinkItem>& items,
                                bool& hadHeadSensitiveCondition) const
 {
-  cmGeneratorExpression ge;
+  cmGeneratorExpression ge(0, this->Makefile->GetLocalGenerator()
+                               ->GetGlobalGenerator()
+                               ->GetGeneratorExpressionParseCache());
   cmGeneratorExpressionDAGChecker dagChecker(this->GetName(), prop, 0, 0);
   // The $<LINK_ONLY> expression may be in a link interface to specify private
   // link dependencies that are otherwise excluded from usage requirements.
@@ -6261,7 +6359,10 @@ void cmTargetInternals::AddInterfaceEntries(
         {
         std::string genex =
           "$<TARGET_PROPERTY:" + *it + "," + prop + ">";
-        cmGeneratorExpression ge(&it->Backtrace);
+        cmGeneratorExpression ge(&it->Backtrace,
+                                 thisTarget->GetMakefile()->GetLocalGenerator()
+                                   ->GetGlobalGenerator()
+                                   ->GetGeneratorExpressionParseCache());
         cmsys::auto_ptr<cmCompiledGeneratorExpression> cge = ge.Parse(genex);
         cge->SetEvaluateForBuildsystem(true);
         entries.push_back(
@@ -6357,7 +6458,10 @@ cmTargetInternals::ComputeLinkImplementationLibraries(
     cmGeneratorExpressionDAGChecker dagChecker(
                                         thisTarget->GetName(),
                                         "LINK_LIBRARIES", 0, 0);
-    cmGeneratorExpression ge(&le->Backtrace);
+    cmGeneratorExpression ge(&le->Backtrace,
+                             thisTarget->GetMakefile()->GetLocalGenerator()
+                               ->GetGlobalGenerator()
+                               ->GetGeneratorExpressionParseCache());
     cmsys::auto_ptr<cmCompiledGeneratorExpression> const cge =
       ge.Parse(le->Value);
     std::string const evaluated =
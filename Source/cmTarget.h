@@ -483,6 +483,11 @@ public:
   // Get the properties
   cmPropertyMap &GetProperties() const { return this->Properties; }
 
+  /** Write everything generators read from this target, including the
+      entries added by target commands and the policy settings, to a
+      stream so that callers can tell whether it changed.  */
+  void WriteState(std::ostream& os) const;
+
   bool GetMappedConfig(std::string const& desired_config,
                        const char** loc,
                        const char** imp,
@@ -54,9 +54,23 @@ int cmXMLParser::ParseFile(const char* file)
     return 0;
     }
 
-  cmOStringStream str;
-  str << ifs.rdbuf();
-  return this->Parse(str.str().c_str());
+  // Feed the file to the parser in blocks so that large files are never
+  // held in memory as a whole.
+  if ( !this->InitializeParser() )
+    {
+    return 0;
+    }
+  char buffer[16384];
+  while ( ifs && !this->ParseError )
+    {
+    ifs.read(buffer, sizeof(buffer));
+    std::streamsize n = ifs.gcount();
+    if ( n > 0 )
+      {
+      this->ParseChunk(buffer, static_cast<std::string::size_type>(n));
+      }
+    }
+  return this->CleanupParser();
 }
 
 //----------------------------------------------------------------------------
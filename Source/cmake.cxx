@@ -17,6 +17,7 @@
 #include "cmCommands.h"
 #include "cmCommand.h"
 #include "cmFileTimeComparison.h"
+#include "cmProfiler.h"
 #include "cmSourceFile.h"
 #include "cmTest.h"
 #include "cmDocumentationFormatter.h"
@@ -116,6 +117,7 @@ void cmWarnUnusedCliWarning(const std::string& variable,
 cmake::cmake()
 {
   this->Trace = false;
+  this->Profiler = 0;
   this->WarnUninitialized = false;
   this->WarnUnused = false;
   this->WarnUnusedCli = true;
@@ -185,6 +187,7 @@ cmake::~cmake()
   delete this->VariableWatch;
 #endif
   delete this->FileComparison;
+  delete this->Profiler;
 }
 
 void cmake::InitializeProperties()
@@ -746,6 +749,20 @@ void cmake::SetArgs(const std::vector<std::string>& args,
       std::cout << "Running with trace output on.\n";
       this->SetTrace(true);
       }
+    else if(arg.find("--profile=",0) == 0)
+      {
+      std::string path = arg.substr(strlen("--profile="));
+      if(path.empty())
+        {
+        cmSystemTools::Error("No file specified for --profile");
+        }
+      else
+        {
+        path = cmSystemTools::CollapseFullPath(path);
+        delete this->Profiler;
+        this->Profiler = new cmProfiler(path);
+        }
+      }
     else if(arg.find("--warn-uninitialized",0) == 0)
       {
       std::cout << "Warn about uninitialized values.\n";
@@ -1298,6 +1315,7 @@ int cmake::HandleDeleteCacheVariables(const std::string& var)
 
 int cmake::Configure()
 {
+  cmProfilerScope profile(this->Profiler, "configure", "Configure");
   if(this->DoSuppressDevWarnings)
     {
     if(this->SuppressDevWarnings)
@@ -1765,6 +1783,7 @@ int cmake::Generate()
     {
     return -1;
     }
+  cmProfilerScope profile(this->Profiler, "generate", "Generate");
   this->GlobalGenerator->DoGenerate();
   if ( !this->GraphVizFile.empty() )
     {
@@ -14,6 +14,7 @@
 #define cmake_h
 
 #include "cmListFileCache.h"
+#include "cmRegularExpressionCache.h"
 #include "cmSystemTools.h"
 #include "cmPropertyDefinitionMap.h"
 #include "cmPropertyMap.h"
@@ -27,6 +28,7 @@ class cmMakefile;
 class cmCommand;
 class cmVariableWatch;
 class cmFileTimeComparison;
+class cmProfiler;
 class cmExternalMakefileProjectGenerator;
 class cmDocumentationSection;
 class cmPolicies;
@@ -319,6 +321,17 @@ class cmake
    */
   cmFileTimeComparison* GetFileComparison() { return this->FileComparison; }
 
+  /**
+   * Get the cache of parsed list files
+   */
+  cmListFileCache* GetListFileCache() { return &this->ListFileCache; }
+
+  /**
+   * Get the cache of compiled regular expressions
+   */
+  cmRegularExpressionCache* GetRegularExpressionCache()
+    { return &this->RegularExpressionCache; }
+
   // Do we want debug output during the cmake run.
   bool GetDebugOutput() { return this->DebugOutput; }
   void SetDebugOutputOn(bool b) { this->DebugOutput = b;}
@@ -326,6 +339,9 @@ class cmake
   // Do we want trace output during the cmake run.
   bool GetTrace() { return this->Trace;}
   void SetTrace(bool b) {  this->Trace = b;}
+
+  // The profiler recording this run, or null without --profile.
+  cmProfiler* GetProfiler() { return this->Profiler; }
   bool GetWarnUninitialized() { return this->WarnUninitialized;}
   void SetWarnUninitialized(bool b) {  this->WarnUninitialized = b;}
   bool GetWarnUnused() { return this->WarnUnused;}
@@ -448,6 +464,7 @@ private:
   WorkingMode CurrentWorkingMode;
   bool DebugOutput;
   bool Trace;
+  cmProfiler* Profiler;
   bool WarnUninitialized;
   bool WarnUnused;
   bool WarnUnusedCli;
@@ -463,6 +480,8 @@ private:
   bool ClearBuildSystem;
   bool DebugTryCompile;
   cmFileTimeComparison* FileComparison;
+  cmListFileCache ListFileCache;
+  cmRegularExpressionCache RegularExpressionCache;
   std::string GraphVizFile;
   std::vector<std::string> DebugConfigs;
   InstalledFilesMap InstalledFiles;
@@ -24,6 +24,7 @@
 #include "cmGlobalGenerator.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
+#include "cmProfiler.h"
 #include <cmsys/Encoding.hxx>
 #include <locale.h>
 
@@ -83,6 +84,7 @@ static const char * cmDocumentationOptions[][2] =
    "useful on one try_compile at a time."},
   {"--debug-output", "Put cmake in a debug mode."},
   {"--trace", "Put cmake in trace mode."},
+  {"--profile=<file>", "Write a timing profile of the cmake run."},
   {"--warn-uninitialized", "Warn about uninitialized values."},
   {"--warn-unused-vars", "Warn about unused variables."},
   {"--no-warn-unused-cli", "Don't warn about command line options."},
@@ -333,6 +335,13 @@ int do_cmake(int ac, char const* const* av)
   cm.SetWorkingMode(workingMode);
 
   int res = cm.Run(args, view_only);
+  if(cmProfiler* profiler = cm.GetProfiler())
+    {
+    if(!profiler->Write() && res == 0)
+      {
+      res = 1;
+      }
+    }
   if ( list_cached || list_all_cached )
     {
     cmCacheManager::CacheIterator it =
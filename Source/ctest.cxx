@@ -104,6 +104,8 @@ static const char * cmDocumentationOptions[][2] =
   {"--extra-submit <file>[;<file>]", "Submit extra files to the dashboard."},
   {"--force-new-ctest-process", "Run child CTest instances as new processes"},
   {"--schedule-random", "Use a random order for scheduling tests"},
+  {"--resource-pool <name>=<capacity>",
+   "Limit the total demand of running tests on a resource pool."},
   {"--submit-index", "Submit individual dashboard tests with specific index"},
   {"--timeout <seconds>", "Set a global timeout on all tests."},
   {"--stop-time <time>",
@@ -1356,6 +1356,162 @@ int kwsysProcess_WaitForExit(kwsysProcess* cp, double* userTimeout)
   return 1;
 }
 
+/*--------------------------------------------------------------------------*/
+int kwsysProcess_WaitForAny(kwsysProcess** processes, int count,
+                            double* userTimeout)
+{
+  kwsysProcessTime userStartTime = {0, 0};
+  kwsysProcessTime timeoutTime = {-1, 0};
+  int timeoutIndex = -1;
+  int first = -1;
+  int ready = -1;
+  int i;
+#if KWSYSPE_USE_SELECT
+  int j;
+#endif
+
+  /* Record the time at which user timeout period starts.  */
+  if(userTimeout)
+    {
+    kwsysProcessTime userTimeoutLength =
+      kwsysProcessTimeFromDouble(*userTimeout > 0? *userTimeout : 0);
+    userStartTime = kwsysProcessTimeGetCurrent();
+    timeoutTime = kwsysProcessTimeAdd(userStartTime, userTimeoutLength);
+    }
+
+  /* Look for a process that is ready without waiting and find the
+     earliest process timeout.  */
+  for(i=0; i < count && ready < 0; ++i)
+    {
+    kwsysProcess* cp = processes[i];
+    kwsysProcessTime processTimeoutTime;
+    if(!cp)
+      {
+      continue;
+      }
+    if(first < 0)
+      {
+      first = i;
+      }
+    if(cp->State != kwsysProcess_State_Executing || cp->Killed ||
+       cp->TimeoutExpired || cp->PipesLeft <= 0)
+      {
+      ready = i;
+      break;
+      }
+#if KWSYSPE_USE_SELECT
+    /* Descriptors reported ready by an earlier call to select have
+       not been read yet.  */
+    for(j=0; j < KWSYSPE_PIPE_COUNT; ++j)
+      {
+      if(cp->PipeReadEnds[j] >= 0 &&
+         FD_ISSET(cp->PipeReadEnds[j], &cp->PipeSet))
+        {
+        ready = i;
+        }
+      }
+#endif
+    kwsysProcessGetTimeoutTime(cp, 0, &processTimeoutTime);
+    if(processTimeoutTime.tv_sec >= 0 &&
+       (timeoutTime.tv_sec < 0 ||
+        kwsysProcessTimeLess(processTimeoutTime, timeoutTime)))
+      {
+      timeoutTime = processTimeoutTime;
+      timeoutIndex = i;
+      }
+    }
+
+  if(ready < 0 && first >= 0)
+    {
+    kwsysProcessTimeNative timeoutLength;
+    if(kwsysProcessGetTimeoutLeft(&timeoutTime, userTimeout,
+                                  &timeoutLength, 0))
+      {
+      /* Timeout has already expired.  */
+      ready = timeoutIndex;
+      }
+    else
+      {
+#if KWSYSPE_USE_SELECT
+      fd_set set;
+      int max = -1;
+      int numReady;
+      FD_ZERO(&set);
+      for(i=0; i < count; ++i)
+        {
+        kwsysProcess* cp = processes[i];
+        for(j=0; cp && j < KWSYSPE_PIPE_COUNT; ++j)
+          {
+          if(cp->PipeReadEnds[j] >= 0)
+            {
+            FD_SET(cp->PipeReadEnds[j], &set);
+            if(cp->PipeReadEnds[j] > max)
+              {
+              max = cp->PipeReadEnds[j];
+              }
+            }
+          }
+        }
+
+      /* Block until data are available on any pipe.  Repeat call
+         until it is not interrupted.  */
+      while(((numReady = select(max+1, &set, 0, 0,
+                                timeoutTime.tv_sec < 0? 0 : &timeoutLength))
+             < 0) && (errno == EINTR));
+      if(numReady == 0)
+        {
+        /* The earliest timeout expired.  */
+        ready = timeoutIndex;
+        }
+      else if(numReady < 0)
+        {
+        /* Let WaitForData report the error.  */
+        ready = first;
+        }
+      for(i=0; i < count && ready < 0; ++i)
+        {
+        kwsysProcess* cp = processes[i];
+        for(j=0; cp && j < KWSYSPE_PIPE_COUNT; ++j)
+          {
+          if(cp->PipeReadEnds[j] >= 0 &&
+             FD_ISSET(cp->PipeReadEnds[j], &set))
+            {
+            ready = i;
+            }
+          }
+        }
+#else
+      /* We cannot wait for the pipes without reading them.  Sleep a
+         little and let the caller poll the first process.  */
+      unsigned int usec = ((timeoutLength.tv_sec * 1000000) +
+                           timeoutLength.tv_usec);
+      if(timeoutTime.tv_sec < 0 || usec > 10000)
+        {
+        usec = 10000;  /* do not sleep more than 10 milliseconds */
+        }
+      kwsysProcess_usleep(usec);
+      ready = first;
+#endif
+      }
+    }
+
+  /* Update the user timeout.  */
+  if(userTimeout)
+    {
+    kwsysProcessTime userEndTime = kwsysProcessTimeGetCurrent();
+    kwsysProcessTime difference = kwsysProcessTimeSubtract(userEndTime,
+                                                           userStartTime);
+    double d = kwsysProcessTimeToDouble(difference);
+    *userTimeout -= d;
+    if(*userTimeout < 0)
+      {
+      *userTimeout = 0;
+      }
+    }
+
+  return ready;
+}
+
 /*--------------------------------------------------------------------------*/
 void kwsysProcess_Kill(kwsysProcess* cp)
 {
@@ -1324,6 +1324,179 @@ int kwsysProcess_WaitForExit(kwsysProcess* cp, double* userTimeout)
   return 1;
 }
 
+/*--------------------------------------------------------------------------*/
+int kwsysProcess_WaitForAny(kwsysProcess** processes, int count,
+                            double* userTimeout)
+{
+  kwsysProcessTime userStartTime;
+  kwsysProcessTime timeoutLength;
+  kwsysProcessTime timeoutTime;
+  PHANDLE events = 0;
+  int* owners = 0;
+  int numEvents = 0;
+  int timeoutIndex = -1;
+  int first = -1;
+  int ready = -1;
+  int i;
+  int j;
+
+  /* Record the time at which user timeout period starts.  */
+  userStartTime = kwsysProcessTimeGetCurrent();
+  timeoutTime.QuadPart = -1;
+  if(userTimeout)
+    {
+    kwsysProcessTime userTimeoutLength =
+      kwsysProcessTimeFromDouble(*userTimeout > 0? *userTimeout : 0);
+    timeoutTime = kwsysProcessTimeAdd(userStartTime, userTimeoutLength);
+    }
+
+  /* Look for a process that is ready without waiting, count the
+     events to wait for, and find the earliest process timeout.  */
+  for(i=0; i < count && ready < 0; ++i)
+    {
+    kwsysProcess* cp = processes[i];
+    kwsysProcessTime processTimeoutTime;
+    if(!cp)
+      {
+      continue;
+      }
+    if(first < 0)
+      {
+      first = i;
+      }
+    if(cp->State != kwsysProcess_State_Executing || cp->Killed ||
+       cp->TimeoutExpired || cp->PipesLeft <= 0)
+      {
+      ready = i;
+      break;
+      }
+
+    /* If we previously got data from a thread, let it know we are
+       done with the data so it can signal when more arrive.  */
+    if(cp->CurrentIndex < KWSYSPE_PIPE_COUNT)
+      {
+      KWSYSPE_DEBUG((stderr, "releasing reader %d\n", cp->CurrentIndex));
+      ReleaseSemaphore(cp->Pipe[cp->CurrentIndex].Reader.Go, 1, 0);
+      cp->CurrentIndex = KWSYSPE_PIPE_COUNT;
+      }
+    numEvents += cp->ProcessEventsLength;
+
+    kwsysProcessGetTimeoutTime(cp, 0, &processTimeoutTime);
+    if(processTimeoutTime.QuadPart >= 0 &&
+       (timeoutTime.QuadPart < 0 ||
+        kwsysProcessTimeLess(processTimeoutTime, timeoutTime)))
+      {
+      timeoutTime = processTimeoutTime;
+      timeoutIndex = i;
+      }
+    }
+
+  /* Collect the events of all processes.  */
+  if(ready < 0 && first >= 0)
+    {
+    events = (PHANDLE)malloc(sizeof(HANDLE)*(numEvents+1));
+    owners = (int*)malloc(sizeof(int)*(numEvents+1));
+    if(!events || !owners)
+      {
+      /* Let the caller poll the first process.  */
+      ready = first;
+      }
+    numEvents = 0;
+    for(i=0; i < count && ready < 0; ++i)
+      {
+      kwsysProcess* cp = processes[i];
+      for(j=0; cp && j < cp->ProcessEventsLength; ++j)
+        {
+        events[numEvents] = cp->ProcessEvents[j];
+        owners[numEvents] = i;
+        ++numEvents;
+        }
+      }
+    }
+
+  /* Wait for a pipe's thread to signal or a process to terminate.
+     WaitForMultipleObjects accepts a limited number of handles so
+     when there are more we poll them in groups.  */
+  while(ready < 0 && first >= 0)
+    {
+    DWORD timeout;
+    DWORD w = WAIT_TIMEOUT;
+    if(kwsysProcessGetTimeoutLeft(&timeoutTime, userTimeout,
+                                  &timeoutLength))
+      {
+      /* Timeout has already expired.  */
+      ready = timeoutIndex;
+      break;
+      }
+    if(timeoutTime.QuadPart < 0)
+      {
+      timeout = INFINITE;
+      }
+    else
+      {
+      timeout = kwsysProcessTimeToDWORD(timeoutLength);
+      }
+
+    for(j=0; j < numEvents && w == WAIT_TIMEOUT;
+        j += MAXIMUM_WAIT_OBJECTS)
+      {
+      int n = numEvents - j;
+      if(n > MAXIMUM_WAIT_OBJECTS)
+        {
+        n = MAXIMUM_WAIT_OBJECTS;
+        }
+      w = WaitForMultipleObjects(n, events+j, 0,
+                                 numEvents > n? 0 : timeout);
+      if(w < WAIT_OBJECT_0 + n)
+        {
+        int k = j + (int)(w - WAIT_OBJECT_0);
+        kwsysProcess* cp = processes[owners[k]];
+        if(events[k] == cp->Full)
+          {
+          /* Leave the signal for WaitForData to take.  */
+          ReleaseSemaphore(cp->Full, 1, 0);
+          }
+        ready = owners[k];
+        }
+      else if(w != WAIT_TIMEOUT)
+        {
+        /* Let WaitForData report the error.  */
+        ready = first;
+        }
+      }
+
+    if(ready < 0)
+      {
+      if(numEvents <= MAXIMUM_WAIT_OBJECTS || timeout == 0)
+        {
+        /* The earliest timeout expired.  */
+        ready = timeoutIndex;
+        break;
+        }
+      /* Sleep a little before polling the groups again.  */
+      Sleep(timeout < 10? timeout : 10);
+      }
+    }
+  free(events);
+  free(owners);
+
+  /* Update the user timeout.  */
+  if(userTimeout)
+    {
+    kwsysProcessTime userEndTime = kwsysProcessTimeGetCurrent();
+    kwsysProcessTime difference = kwsysProcessTimeSubtract(userEndTime,
+                                                           userStartTime);
+    double d = kwsysProcessTimeToDouble(difference);
+    *userTimeout -= d;
+    if(*userTimeout < 0)
+      {
+      *userTimeout = 0;
+      }
+    }
+
+  return ready;
+}
+
 /*--------------------------------------------------------------------------*/
 void kwsysProcess_Kill(kwsysProcess* cp)
 {
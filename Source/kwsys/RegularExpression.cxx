@@ -30,11 +30,15 @@
 
 #include "kwsysPrivate.h"
 #include KWSYS_HEADER(RegularExpression.hxx)
+#include KWSYS_HEADER(stl/algorithm)
+#include KWSYS_HEADER(stl/map)
+#include KWSYS_HEADER(stl/vector)
 
 // Work-around CMake dependency scanning limitation.  This must
 // duplicate the above list of headers.
 #if 0
 # include "RegularExpression.hxx.in"
+# include "kwsys_stl.hxx.in"
 #endif
 
 #include <stdio.h>
@@ -43,8 +47,90 @@
 namespace KWSYS_NAMESPACE
 {
 
+// RegularExpressionLinear -- Linear-time matcher for a compiled program.
+// The program is translated into a flat list of instructions which is
+// run by a lazily built DFA to decide whether there is a match at all,
+// and then by a Pike-style simulation that follows every path in
+// priority order to recover the same match and submatches the
+// backtracking matcher would report.
+class RegularExpressionLinear
+{
+public:
+  RegularExpressionLinear(const char* program, bool anchored);
+  bool find(const char* string, const char** startp, const char** endp);
+
+private:
+  enum { NSLOT = 2 * RegularExpression::NSUBEXP };
+  enum Op { IChar, IAny, IClass, ISplit, IJump, ISave, IBol, IEol,
+            IMatch, IFail };
+  struct Instruction
+  {
+    Op  Code;
+    int Arg;    // Character, class index or capture slot.
+    int Next;   // Following instruction.
+    int Alt;    // Lower priority choice of a split.
+  };
+  struct ThreadList
+  {
+    kwsys_stl::vector<int> PC;
+    kwsys_stl::vector<const char*> Caps;
+    kwsys_stl::vector<unsigned int> Marks;
+    unsigned int Generation;
+  };
+  struct StackEntry
+  {
+    int PC;             // Instruction to visit, or -1 to restore a slot.
+    int Slot;
+    const char* Value;
+  };
+
+  int node(const char* p);
+  int follow(const char* p);
+  int emit(Op code, int arg, int next, int alt);
+  Instruction single(const char* p, int next);
+  bool accepts(Instruction const& in, unsigned char c) const;
+
+  // Automaton used to reject input quickly.
+  enum { DFAMaxStates = 1024, DFAMaxFlushes = 8 };
+  int scan(const char* string);
+  void newClosure();
+  void closure(int pc, bool atStart, bool atEnd,
+               kwsys_stl::vector<int>& set);
+  int state(kwsys_stl::vector<int>& set);
+  int step(int s, unsigned char c);
+  bool matchesAtEnd(int s);
+  void flush();
+
+  // Simulation that reports the submatches.
+  bool simulate(const char* string, const char** startp, const char** endp);
+  void add(ThreadList& l, int pc, const char** caps, const char* sp);
+  void clear(ThreadList& l);
+
+  kwsys_stl::vector<Instruction> Program;
+  kwsys_stl::vector<unsigned char> Classes;
+  kwsys_stl::map<const char*, int> NodeIndex;
+  kwsys_stl::vector<const char*> Pending;
+  int Start;
+  bool Anchored;
+  const char* Bol;
+
+  kwsys_stl::map<kwsys_stl::vector<int>, int> StateIndex;
+  kwsys_stl::vector<kwsys_stl::vector<int> > StateSets;
+  kwsys_stl::vector<int> Transitions;
+  kwsys_stl::vector<char> Accepting;
+  kwsys_stl::vector<signed char> AtEnd;
+  kwsys_stl::vector<int> ClosureStack;
+  kwsys_stl::vector<unsigned int> ClosureMarks;
+  unsigned int ClosureGeneration;
+
+  ThreadList Lists[2];
+  kwsys_stl::vector<StackEntry> Stack;
+};
+
 // RegularExpression -- Copies the given regular expression.
 RegularExpression::RegularExpression (const RegularExpression& rxp) {
+  this->engine = rxp.engine;
+  this->linear = 0;
   if ( !rxp.program )
     {
     this->program = 0;
@@ -79,6 +165,9 @@ RegularExpression& RegularExpression::operator= (const RegularExpression& rxp)
     {
     return *this;
     }
+  this->engine = rxp.engine;
+  delete this->linear;
+  this->linear = 0;
   if ( !rxp.program )
     {
     this->program = 0;
@@ -109,6 +198,22 @@ RegularExpression& RegularExpression::operator= (const RegularExpression& rxp)
   return *this;
 }
 
+// ~RegularExpression -- Frees space allocated for the regular expression.
+RegularExpression::~RegularExpression ()
+{
+  delete [] this->program;
+  delete this->linear;
+}
+
+// set_invalid -- Marks the regular expression as invalid.
+void RegularExpression::set_invalid ()
+{
+  delete [] this->program;
+  this->program = 0;
+  delete this->linear;
+  this->linear = 0;
+}
+
 // operator== -- Returns true if two regular expressions have the same
 // compiled program for pattern matching.
 bool RegularExpression::operator== (const RegularExpression& rxp) const {
@@ -381,6 +486,8 @@ bool RegularExpression::compile (const char* exp) {
 //#endif
     this->program = new char[regsize];
     this->progsize = static_cast<int>(regsize);
+    delete this->linear;
+    this->linear = 0;
 
     if (this->program == 0) {
       //RAISE Error, SYM(RegularExpression), SYM(Out_Of_Memory),
@@ -914,6 +1021,14 @@ bool RegularExpression::find (const char* string) {
             return (0);
     }
 
+    // The linear engine handles everything past the quick rejection.
+    if (this->engine == Linear) {
+        if (this->linear == 0)
+            this->linear =
+              new RegularExpressionLinear(this->program, this->reganch != 0);
+        return this->linear->find(string, this->startp, this->endp);
+    }
+
     // Mark beginning of line for ^ .
     regbol = string;
 
@@ -1241,4 +1356,563 @@ static char* regnext (char* p) {
         return (p + offset);
 }
 
+
+////////////////////////////////////////////////////////////////////////
+//
+//  linear-time matching
+//
+////////////////////////////////////////////////////////////////////////
+
+/*
+ * The linear engine never recurses on the input.  The compiled program is
+ * translated once into instructions where each "next" pointer becomes an
+ * index, BRANCH chains become SPLITs that prefer the earlier alternative,
+ * and STAR/PLUS become greedy loops around a single-character instruction.
+ * These preferences reproduce the order in which regmatch() tries paths,
+ * so the first path to reach END in the simulation is the one the
+ * backtracking matcher would have returned.
+ */
+
+RegularExpressionLinear::RegularExpressionLinear (const char* program,
+                                                  bool anchored) {
+    this->Anchored = anchored;
+    this->Bol = 0;
+
+    // Slot 0 records where an attempt starts.
+    this->Start = this->emit(ISave, 0, -1, -1);
+    int first = this->node(program + 1);
+    this->Program[this->Start].Next = first;
+
+    while (!this->Pending.empty()) {
+        const char* p = this->Pending.back();
+        this->Pending.pop_back();
+        int i = this->NodeIndex[p];
+        const char* next = regnext(p);
+        Instruction in;
+        in.Code = IJump;
+        in.Arg = 0;
+        in.Alt = -1;
+        switch (OP(p)) {
+            case END:
+                in.Code = IMatch;
+                in.Next = -1;
+                break;
+            case BOL:
+                in.Code = IBol;
+                in.Next = this->follow(p);
+                break;
+            case EOL:
+                in.Code = IEol;
+                in.Next = this->follow(p);
+                break;
+            case ANY:
+            case ANYOF:
+            case ANYBUT:
+                in = this->single(p, this->follow(p));
+                break;
+            case EXACTLY:{
+                    // One instruction per character, built back to front.
+                    const char* opnd = OPERAND(p);
+                    int n = this->follow(p);
+                    for (size_t k = strlen(opnd); k > 1; --k)
+                        n = this->emit(IChar, UCHARAT(opnd + k - 1), n, -1);
+                    in.Code = IChar;
+                    in.Arg = UCHARAT(opnd);
+                    in.Next = n;
+                }
+                break;
+            case NOTHING:
+            case BACK:
+                in.Next = this->follow(p);
+                break;
+            case BRANCH:
+                if (next == 0 || OP(next) != BRANCH)     // No choice.
+                    in.Next = this->node(OPERAND(p));
+                else {
+                    in.Code = ISplit;
+                    in.Next = this->node(OPERAND(p));
+                    in.Alt = this->node(next);
+                }
+                break;
+            case STAR:{
+                    // Either one more repetition or what follows.
+                    int out = this->follow(p);
+                    int body = static_cast<int>(this->Program.size());
+                    this->Program.push_back(this->single(OPERAND(p), i));
+                    in.Code = ISplit;
+                    in.Next = body;
+                    in.Alt = out;
+                }
+                break;
+            case PLUS:{
+                    int out = this->follow(p);
+                    int loop = this->emit(ISplit, 0, i, out);
+                    in = this->single(OPERAND(p), loop);
+                }
+                break;
+            default:
+                if (OP(p) > OPEN &&
+                    OP(p) < OPEN + RegularExpression::NSUBEXP) {
+                    in.Code = ISave;
+                    in.Arg = 2 * (OP(p) - OPEN);
+                    in.Next = this->follow(p);
+                }
+                else if (OP(p) > CLOSE &&
+                         OP(p) < CLOSE + RegularExpression::NSUBEXP) {
+                    in.Code = ISave;
+                    in.Arg = 2 * (OP(p) - CLOSE) + 1;
+                    in.Next = this->follow(p);
+                }
+                else {
+                    in.Code = IFail;
+                    in.Next = -1;
+                }
+                break;
+        }
+        this->Program[i] = in;
+    }
+
+    this->NodeIndex.clear();
+    this->ClosureMarks.resize(this->Program.size(), 0);
+    this->ClosureGeneration = 0;
+    for (int l = 0; l < 2; ++l) {
+        this->Lists[l].Marks.resize(this->Program.size(), 0);
+        this->Lists[l].Caps.resize(this->Program.size() * NSLOT, 0);
+        this->Lists[l].Generation = 0;
+    }
+}
+
+
+/*
+ - node - instruction index for a program node, translated later
+ */
+int RegularExpressionLinear::node (const char* p) {
+    kwsys_stl::map<const char*, int>::iterator it = this->NodeIndex.find(p);
+    if (it != this->NodeIndex.end())
+        return (it->second);
+    int i = this->emit(IFail, 0, -1, -1);
+    this->NodeIndex[p] = i;
+    this->Pending.push_back(p);
+    return (i);
+}
+
+
+/*
+ - follow - instruction index for whatever comes after a node
+ */
+int RegularExpressionLinear::follow (const char* p) {
+    const char* next = regnext(p);
+    if (next == 0)
+        return (this->emit(IFail, 0, -1, -1));
+    return (this->node(next));
+}
+
+
+/*
+ - emit - append an instruction
+ */
+int RegularExpressionLinear::emit (Op code, int arg, int next, int alt) {
+    Instruction in;
+    in.Code = code;
+    in.Arg = arg;
+    in.Next = next;
+    in.Alt = alt;
+    this->Program.push_back(in);
+    return (static_cast<int>(this->Program.size()) - 1);
+}
+
+
+/*
+ - single - instruction matching one character like a simple node
+ */
+RegularExpressionLinear::Instruction
+RegularExpressionLinear::single (const char* p, int next) {
+    Instruction in;
+    in.Code = IFail;
+    in.Arg = 0;
+    in.Next = next;
+    in.Alt = -1;
+    switch (OP(p)) {
+        case ANY:
+            in.Code = IAny;
+            break;
+        case EXACTLY:
+            in.Code = IChar;
+            in.Arg = UCHARAT(OPERAND(p));
+            break;
+        case ANYOF:
+        case ANYBUT:{
+                size_t base = this->Classes.size();
+                this->Classes.resize(base + 256, OP(p) == ANYBUT);
+                for (const char* c = OPERAND(p); *c != '\0'; ++c)
+                    this->Classes[base + UCHARAT(c)] = (OP(p) == ANYOF);
+                this->Classes[base] = 0;  // Never match the terminator.
+                in.Code = IClass;
+                in.Arg = static_cast<int>(base / 256);
+            }
+            break;
+        default:
+            break;
+    }
+    return (in);
+}
+
+
+/*
+ - accepts - does a consuming instruction match the character
+ */
+inline bool RegularExpressionLinear::accepts (Instruction const& in,
+                                              unsigned char c) const {
+    switch (in.Code) {
+        case IChar:
+            return (c == in.Arg);
+        case IAny:
+            return (c != '\0');
+        case IClass:
+            return (this->Classes[in.Arg * 256 + c] != 0);
+        default:
+            return (false);
+    }
+}
+
+
+// find -- Runs the automaton to reject the input cheaply, then the
+// simulation to locate the match and submatches.
+bool RegularExpressionLinear::find (const char* string, const char** startp,
+                                    const char** endp) {
+    if (this->scan(string) == 0)
+        return (false);
+    return (this->simulate(string, startp, endp));
+}
+
+
+/*
+ - scan - run the DFA over the string
+ *
+ * States are sets of consuming instructions and are built on demand.  The
+ * cache is bounded by DFAMaxStates; when it fills up it is thrown away and
+ * rebuilt from the current state.  If that keeps happening the input is
+ * left to the simulation.  1 match, 0 no match, -1 undecided.
+ */
+int RegularExpressionLinear::scan (const char* string) {
+    if (*string == '\0')        // ^ and $ meet; let simulate() sort it out.
+        return (-1);
+
+    kwsys_stl::vector<int> set;
+    this->newClosure();
+    this->closure(this->Start, true, false, set);
+    int s = this->state(set);
+    if (s < 0) {
+        this->flush();
+        s = this->state(set);
+    }
+
+    int flushes = 0;
+    for (const char* sp = string; *sp != '\0'; ++sp) {
+        if (this->Accepting[s])
+            return (1);
+        if (this->StateSets[s].empty())
+            return (0);
+        int next = this->step(s, UCHARAT(sp));
+        if (next < 0) {
+            if (++flushes > DFAMaxFlushes)
+                return (-1);
+            set = this->StateSets[s];
+            this->flush();
+            s = this->state(set);
+            next = this->step(s, UCHARAT(sp));
+        }
+        s = next;
+    }
+    return ((this->Accepting[s] || this->matchesAtEnd(s)) ? 1 : 0);
+}
+
+
+/*
+ - newClosure - start a set of closures that share visited marks
+ */
+void RegularExpressionLinear::newClosure () {
+    if (++this->ClosureGeneration == 0) {
+        kwsys_stl::fill(this->ClosureMarks.begin(), this->ClosureMarks.end(),
+                        0u);
+        this->ClosureGeneration = 1;
+    }
+}
+
+
+/*
+ - closure - add the consuming instructions reachable from pc
+ *
+ * Instructions already visited in the current generation are skipped.
+ * EOL stays in the set unless the end of the input has been reached.
+ */
+void RegularExpressionLinear::closure (int pc, bool atStart, bool atEnd,
+                                       kwsys_stl::vector<int>& set) {
+    kwsys_stl::vector<int>& stack = this->ClosureStack;
+    stack.push_back(pc);
+    while (!stack.empty()) {
+        pc = stack.back();
+        stack.pop_back();
+        if (this->ClosureMarks[pc] == this->ClosureGeneration)
+            continue;
+        this->ClosureMarks[pc] = this->ClosureGeneration;
+        Instruction const& in = this->Program[pc];
+        switch (in.Code) {
+            case IJump:
+            case ISave:
+                stack.push_back(in.Next);
+                break;
+            case ISplit:
+                stack.push_back(in.Alt);
+                stack.push_back(in.Next);
+                break;
+            case IBol:
+                if (atStart)
+                    stack.push_back(in.Next);
+                break;
+            case IEol:
+                if (atEnd)
+                    stack.push_back(in.Next);
+                else
+                    set.push_back(pc);
+                break;
+            case IFail:
+                break;
+            default:
+                set.push_back(pc);
+                break;
+        }
+    }
+}
+
+
+/*
+ - state - index of the DFA state for a set, -1 if the cache is full
+ */
+int RegularExpressionLinear::state (kwsys_stl::vector<int>& set) {
+    kwsys_stl::sort(set.begin(), set.end());
+    kwsys_stl::map<kwsys_stl::vector<int>, int>::iterator it =
+      this->StateIndex.find(set);
+    if (it != this->StateIndex.end())
+        return (it->second);
+    if (this->StateSets.size() >= DFAMaxStates)
+        return (-1);
+
+    int s = static_cast<int>(this->StateSets.size());
+    char accepting = 0;
+    for (size_t k = 0; k < set.size(); ++k)
+        if (this->Program[set[k]].Code == IMatch)
+            accepting = 1;
+    this->StateIndex[set] = s;
+    this->StateSets.push_back(set);
+    this->Transitions.resize(this->Transitions.size() + 256, -1);
+    this->Accepting.push_back(accepting);
+    this->AtEnd.push_back(-1);
+    return (s);
+}
+
+
+/*
+ - step - DFA transition on one character, -1 if the cache is full
+ */
+int RegularExpressionLinear::step (int s, unsigned char c) {
+    int next = this->Transitions[s * 256 + c];
+    if (next >= 0)
+        return (next);
+
+    kwsys_stl::vector<int> set;
+    this->newClosure();
+    kwsys_stl::vector<int> const& from = this->StateSets[s];
+    for (size_t k = 0; k < from.size(); ++k) {
+        Instruction const& in = this->Program[from[k]];
+        if (this->accepts(in, c))
+            this->closure(in.Next, false, false, set);
+    }
+    if (!this->Anchored)        // A new attempt may start after c.
+        this->closure(this->Start, false, false, set);
+    next = this->state(set);
+    if (next >= 0)
+        this->Transitions[s * 256 + c] = next;
+    return (next);
+}
+
+
+/*
+ - matchesAtEnd - can a state reach END once $ is satisfied
+ */
+bool RegularExpressionLinear::matchesAtEnd (int s) {
+    if (this->AtEnd[s] < 0) {
+        kwsys_stl::vector<int> set;
+        this->newClosure();
+        kwsys_stl::vector<int> const& from = this->StateSets[s];
+        for (size_t k = 0; k < from.size(); ++k)
+            if (this->Program[from[k]].Code == IEol)
+                this->closure(this->Program[from[k]].Next, false, true, set);
+        this->AtEnd[s] = 0;
+        for (size_t k = 0; k < set.size(); ++k)
+            if (this->Program[set[k]].Code == IMatch)
+                this->AtEnd[s] = 1;
+    }
+    return (this->AtEnd[s] != 0);
+}
+
+
+/*
+ - flush - forget all DFA states
+ */
+void RegularExpressionLinear::flush () {
+    this->StateIndex.clear();
+    this->StateSets.clear();
+    this->Transitions.clear();
+    this->Accepting.clear();
+    this->AtEnd.clear();
+}
+
+
+/*
+ - simulate - follow all paths through the program in lock step
+ *
+ * Each list holds at most one thread per instruction, in priority order.
+ * A new attempt joins at the lowest priority at every position until a
+ * match is found; after that only threads that outrank the match keep
+ * running.
+ */
+bool RegularExpressionLinear::simulate (const char* string,
+                                        const char** startp,
+                                        const char** endp) {
+    ThreadList* clist = &this->Lists[0];
+    ThreadList* nlist = &this->Lists[1];
+    const char* caps[NSLOT];
+    const char* found[NSLOT];
+    bool matched = false;
+    int k;
+
+    this->Bol = string;
+    this->clear(*clist);
+    for (const char* sp = string; ; ++sp) {
+        if (!matched && (!this->Anchored || sp == string)) {
+            for (k = 0; k < NSLOT; ++k)
+                caps[k] = 0;
+            this->add(*clist, this->Start, caps, sp);
+        }
+        if (clist->PC.empty() && (matched || this->Anchored))
+            break;
+
+        unsigned char c = UCHARAT(sp);
+        this->clear(*nlist);
+        for (size_t t = 0; t < clist->PC.size(); ++t) {
+            Instruction const& in = this->Program[clist->PC[t]];
+            const char** tcaps = &clist->Caps[t * NSLOT];
+            if (in.Code == IMatch) {
+                for (k = 0; k < NSLOT; ++k)
+                    found[k] = tcaps[k];
+                found[1] = sp;
+                matched = true;
+                break;          // Lower priority threads cannot win.
+            }
+            if (this->accepts(in, c)) {
+                for (k = 0; k < NSLOT; ++k)
+                    caps[k] = tcaps[k];
+                this->add(*nlist, in.Next, caps, sp + 1);
+            }
+        }
+        ThreadList* tmp = clist;
+        clist = nlist;
+        nlist = tmp;
+        if (c == '\0')
+            break;
+    }
+
+    if (matched)
+        for (k = 0; k < RegularExpression::NSUBEXP; ++k) {
+            startp[k] = found[2 * k];
+            endp[k] = found[2 * k + 1];
+        }
+    return (matched);
+}
+
+
+/*
+ - add - add a thread and everything reachable without input
+ *
+ * Uses an explicit stack so deep programs do not recurse; captures
+ * changed on the way down are restored when the stack unwinds past them.
+ */
+void RegularExpressionLinear::add (ThreadList& l, int pc,
+                                   const char** caps, const char* sp) {
+    kwsys_stl::vector<StackEntry>& stack = this->Stack;
+    StackEntry e;
+    e.PC = pc;
+    e.Slot = 0;
+    e.Value = 0;
+    stack.push_back(e);
+    while (!stack.empty()) {
+        e = stack.back();
+        stack.pop_back();
+        if (e.PC < 0) {
+            caps[e.Slot] = e.Value;
+            continue;
+        }
+        if (l.Marks[e.PC] == l.Generation)
+            continue;
+        l.Marks[e.PC] = l.Generation;
+        Instruction const& in = this->Program[e.PC];
+        StackEntry n;
+        n.PC = in.Next;
+        n.Slot = 0;
+        n.Value = 0;
+        switch (in.Code) {
+            case IJump:
+                stack.push_back(n);
+                break;
+            case ISplit:{
+                    StackEntry alt = n;
+                    alt.PC = in.Alt;
+                    stack.push_back(alt);
+                    stack.push_back(n);
+                }
+                break;
+            case ISave:{
+                    StackEntry restore;
+                    restore.PC = -1;
+                    restore.Slot = in.Arg;
+                    restore.Value = caps[in.Arg];
+                    stack.push_back(restore);
+                    caps[in.Arg] = sp;
+                    stack.push_back(n);
+                }
+                break;
+            case IBol:
+                if (sp == this->Bol)
+                    stack.push_back(n);
+                break;
+            case IEol:
+                if (*sp == '\0')
+                    stack.push_back(n);
+                break;
+            case IFail:
+                break;
+            default:{
+                    size_t t = l.PC.size();
+                    l.PC.push_back(e.PC);
+                    for (int k = 0; k < NSLOT; ++k)
+                        l.Caps[t * NSLOT + k] = caps[k];
+                }
+                break;
+        }
+    }
+}
+
+
+/*
+ - clear - empty a thread list
+ */
+void RegularExpressionLinear::clear (ThreadList& l) {
+    l.PC.clear();
+    if (++l.Generation == 0) {
+        kwsys_stl::fill(l.Marks.begin(), l.Marks.end(), 0u);
+        l.Generation = 1;
+    }
+}
+
 } // namespace KWSYS_NAMESPACE
@@ -394,6 +394,117 @@ int runChild(const char* cmd[], int state, int exception, int value,
   return result;
 }
 
+/* Run several children at once and wait for them with WaitForAny.
+   The first exits immediately, the second sleeps for a second, and
+   the third sleeps much longer than its timeout.  */
+static int test9(const char* argv0)
+{
+  const char* cmds[3][4] =
+  {
+    {0, "run", "1", 0},
+    {0, "run", "7", 0},
+    {0, "run", "3", 0}
+  };
+  double timeouts[3] = {10, 10, 0.5};
+  int states[3] =
+  {
+    kwsysProcess_State_Exited,
+    kwsysProcess_State_Exited,
+    kwsysProcess_State_Expired
+  };
+  kwsysProcess* all[3] = {0, 0, 0};
+  /* Leave a null entry in the array to check that it is ignored.  */
+  kwsysProcess* waiting[4] = {0, 0, 0, 0};
+  int order[3] = {-1, -1, -1};
+  int done = 0;
+  int result = 0;
+  int i;
+
+  /* No process to wait for.  */
+  if(kwsysProcess_WaitForAny(waiting, 4, 0) != -1)
+    {
+    fprintf(stderr, "WaitForAny did not return -1 with no processes!\n");
+    return 1;
+    }
+
+  for(i=0; i < 3; ++i)
+    {
+    if(!(all[i] = kwsysProcess_New()))
+      {
+      fprintf(stderr, "kwsysProcess_New returned NULL!\n");
+      result = 1;
+      break;
+      }
+    cmds[i][0] = argv0;
+    kwsysProcess_SetCommand(all[i], cmds[i]);
+    kwsysProcess_SetTimeout(all[i], timeouts[i]);
+    kwsysProcess_Execute(all[i]);
+    waiting[i+1] = all[i];
+    }
+
+  while(result == 0 && done < 3)
+    {
+    double timeout = 30;
+    double zero = 0;
+    char* data;
+    int length;
+    int pipeId;
+    int ready = kwsysProcess_WaitForAny(waiting, 4, &timeout);
+    if(ready < 1)
+      {
+      fprintf(stderr, "WaitForAny returned %d!\n", ready);
+      result = 1;
+      break;
+      }
+
+    /* Consume everything available without blocking.  */
+    while((pipeId = kwsysProcess_WaitForData(waiting[ready], &data, &length,
+                                             &zero)) > 0)
+      {
+      /* Discard the output.  */
+      }
+    if(pipeId == kwsysProcess_Pipe_None)
+      {
+      kwsysProcess_WaitForExit(waiting[ready], 0);
+      order[done++] = ready-1;
+      waiting[ready] = 0;
+      }
+    }
+
+  for(i=0; i < 3 && result == 0; ++i)
+    {
+    int state = kwsysProcess_GetState(all[i]);
+    if(state != states[i])
+      {
+      fprintf(stderr, "Child %d ended in state %d, expected %d!\n",
+              i, state, states[i]);
+      result = 1;
+      }
+    else if(state == kwsysProcess_State_Exited &&
+            kwsysProcess_GetExitValue(all[i]) != 0)
+      {
+      fprintf(stderr, "Child %d exited with value %d!\n",
+              i, kwsysProcess_GetExitValue(all[i]));
+      result = 1;
+      }
+    }
+  if(result == 0 && order[0] != 0)
+    {
+    fprintf(stderr, "Child %d finished before the one exiting early!\n",
+            order[0]);
+    result = 1;
+    }
+
+  for(i=0; i < 3; ++i)
+    {
+    if(all[i])
+      {
+      kwsysProcess_Delete(all[i]);
+      }
+    }
+  return result;
+}
+
 int main(int argc, const char* argv[])
 {
   int n = 0;
@@ -527,6 +638,21 @@ int main(int argc, const char* argv[])
 #endif
     return r;
     }
+  else if(n == 9 && argc == 2)
+    {
+    /* This is the parent process for the WaitForAny test.  */
+    int r;
+    fprintf(stdout, "Output on stdout before test %d.\n", n);
+    fprintf(stderr, "Output on stderr before test %d.\n", n);
+    fflush(stdout);
+    fflush(stderr);
+    r = test9(argv[0]);
+    fprintf(stdout, "Output on stdout after test %d.\n", n);
+    fprintf(stderr, "Output on stderr after test %d.\n", n);
+    fflush(stdout);
+    fflush(stderr);
+    return r;
+    }
   else if(argc > 2 && strcmp(argv[1], "0") == 0)
     {
     /* This is the special debugging test to run a given command
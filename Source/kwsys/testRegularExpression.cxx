@@ -0,0 +1,312 @@
+/*============================================================================
+  KWSys - Kitware System Library
+  Copyright 2000-2014 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "kwsysPrivate.h"
+#include KWSYS_HEADER(RegularExpression.hxx)
+#include KWSYS_HEADER(ios/iostream)
+#include KWSYS_HEADER(stl/string)
+#include KWSYS_HEADER(stl/vector)
+
+// Work-around CMake dependency scanning limitation.  This must
+// duplicate the above list of headers.
+#if 0
+# include "RegularExpression.hxx.in"
+# include "kwsys_ios_iostream.h.in"
+# include "kwsys_stl.hxx.in"
+# include "kwsys_stl_string.hxx.in"
+#endif
+
+#include <time.h>
+
+// Hand-picked cases covering every node type and the choices the
+// backtracking matcher makes between alternatives and repetitions.
+static const char* patterns[] = {
+  "", "a", "abc", "^abc", "abc$", "^$", "^", "$", "a.c", "a*", "a+", "a?",
+  "ab*c", "ab+c", "ab?c", "[abc]+", "[^abc]+", "[a-c]*d", "[]a]", "[-a]+",
+  "(a)", "(a)(b)(c)", "(a|b)+", "(a|ab)(c|bcd)(d*)", "(ab)*b", "(ab?)+b",
+  "(a+|b)*", "(a+|b)+", "(a+|b)?", "((a)|b)+", "(a|b)*c", "x(a|b|)y",
+  "^(a|ab)*$", "(.*)=(.*)", "([^ :]+):([0-9]+): ([^ \t])", "(a*)(a*)",
+  "(a?)(a?)(a?)aaa", "(ab|a)(bc|c)", "((a|b)c)*c", "a\\.b", "\\(x\\)",
+  "(^a|b)", "(a$|b)c", "a|^b|c$", "(((((((((a)))))))))", "^(.*)x(.*)$",
+  0
+};
+
+static const char* subjects[] = {
+  "", "a", "b", "abc", "xabcx", "aaa", "aab", "abab", "abcd", "abbbc",
+  "ac", "]a", "--a", "ddd", "aaaaab", "ab ac", "abcbcd", "x=y=z", "bac",
+  "foo.c:12: error", "a.b", "(x)", "xy", "xay", "xaby", "baaac", "zzxzz",
+  "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "abababababababababababababc",
+  0
+};
+
+//----------------------------------------------------------------------------
+static bool compareEngines(const char* pattern, const char* subject)
+{
+  kwsys::RegularExpression backtracking;
+  if(!backtracking.compile(pattern))
+    {
+    return true;
+    }
+  kwsys::RegularExpression linear(backtracking);
+  linear.set_engine(kwsys::RegularExpression::Linear);
+
+  bool b = backtracking.find(subject);
+  bool l = linear.find(subject);
+  bool same = (b == l);
+  for(int n = 0; same && b && n < kwsys::RegularExpression::NSUBEXP; ++n)
+    {
+    same = (backtracking.start(n) == linear.start(n) &&
+            backtracking.end(n) == linear.end(n));
+    }
+  if(!same)
+    {
+    kwsys_ios::cerr << "Engines disagree on \"" << pattern << "\" in \""
+                    << subject << "\"" << kwsys_ios::endl;
+    }
+  return same;
+}
+
+//----------------------------------------------------------------------------
+static bool testFixedCases()
+{
+  bool ok = true;
+  for(const char** p = patterns; *p; ++p)
+    {
+    for(const char** s = subjects; *s; ++s)
+      {
+      ok = compareEngines(*p, *s) && ok;
+      }
+    }
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+static unsigned int randomState = 1;
+static unsigned int randomNumber(unsigned int n)
+{
+  randomState = randomState * 1103515245u + 12345u;
+  return (randomState >> 16) % n;
+}
+
+//----------------------------------------------------------------------------
+// Build a random expression.  When the result will be repeated with * or +
+// each alternative starts with something that consumes input, because the
+// compiler rejects repetitions of what could match the empty string.  The
+// number of groups is kept within the compiler's limit of NSUBEXP-1.
+static kwsys_stl::string randomPattern(int depth, bool needWidth,
+                                       int& groups)
+{
+  static const char* atoms[] = {
+    "a", "b", "c", "ab", ".", "[ab]", "[^a]", "^", "$", 0
+  };
+  kwsys_stl::string out;
+  int pieces = 1 + static_cast<int>(randomNumber(3));
+  for(int i = 0; i < pieces; ++i)
+    {
+    bool width = needWidth && i == 0;
+    bool group = depth < 3 && randomNumber(4) == 0 &&
+      groups < kwsys::RegularExpression::NSUBEXP - 1;
+    unsigned int repeat = randomNumber(6);
+    if(group)
+      {
+      bool inner = width || repeat < 2;
+      ++groups;
+      out += "(" + randomPattern(depth + 1, inner, groups);
+      if(randomNumber(2))
+        {
+        out += "|" + randomPattern(depth + 1, inner, groups);
+        }
+      out += ")";
+      }
+    else
+      {
+      unsigned int atom = randomNumber(9);
+      if(atom >= 7 && (width || repeat < 3))
+        {
+        atom = 0;
+        }
+      out += atoms[atom];
+      }
+    switch(repeat)
+      {
+      case 0: out += width? "+" : "*"; break;
+      case 1: out += "+"; break;
+      case 2: out += width? "" : "?"; break;
+      default: break;
+      }
+    }
+  return out;
+}
+
+//----------------------------------------------------------------------------
+static bool testRandomCases()
+{
+  bool ok = true;
+  int compared = 0;
+  for(int i = 0; i < 2000; ++i)
+    {
+    int groups = 0;
+    kwsys_stl::string pattern = randomPattern(0, false, groups);
+    for(int j = 0; j < 20; ++j)
+      {
+      kwsys_stl::string subject;
+      unsigned int len = randomNumber(12);
+      for(unsigned int k = 0; k < len; ++k)
+        {
+        subject += static_cast<char>('a' + randomNumber(3));
+        }
+      ok = compareEngines(pattern.c_str(), subject.c_str()) && ok;
+      ++compared;
+      }
+    }
+  kwsys_ios::cout << "Compared " << compared << " random cases"
+                  << kwsys_ios::endl;
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+static bool testPathological()
+{
+  // Exponential for the backtracking matcher.
+  kwsys::RegularExpression re("(a|aa)*b");
+  re.set_engine(kwsys::RegularExpression::Linear);
+  kwsys_stl::string subject(20000, 'a');
+  if(re.find(subject))
+    {
+    kwsys_ios::cerr << "(a|aa)*b matched only a's" << kwsys_ios::endl;
+    return false;
+    }
+  subject += "b";
+  if(!re.find(subject) || re.start() != 0 || re.end() != subject.size())
+    {
+    kwsys_ios::cerr << "(a|aa)*b did not match the whole input"
+                    << kwsys_ios::endl;
+    return false;
+    }
+  return true;
+}
+
+// A selection of the expressions ctest uses to classify build output.
+static const char* buildLogPatterns[] = {
+  "^[Bb]us [Ee]rror",
+  "^[Ss]egmentation [Vv]iolation",
+  ":.*[Pp]ermission [Dd]enied",
+  "([^ :]+):([0-9]+): ([^ \\t])",
+  "([^:]+): error[ \\t]*[0-9]+[ \\t]*:",
+  "^Error ([0-9]+):",
+  "^\"[^\"]+\", line [0-9]+: [^Ww]",
+  "^ld([^:])*:([ \\t])*ERROR([^:])*:",
+  "([^ :]+) : (error|fatal error|catastrophic error)",
+  "([^:]+): (Error:|error|undefined reference|multiply defined)",
+  "([^:]+)\\(([^\\)]+)\\) ?: (error|fatal error|catastrophic error)",
+  "^cc[^C]*CC: ERROR File = ([^,]+), Line = ([0-9]+)",
+  "([^ :]+):([0-9]+): warning:",
+  "^ld([^:])*:([ \\t])*WARNING([^:])*:",
+  "([^:]+): warning ([0-9]+):",
+  "^\"[^\"]+\", line [0-9]+: [Ww](arning|arnung)",
+  "([^:]+): warning[ \\t]*[0-9]+[ \\t]*:",
+  "^(Warning|Warnung) ([0-9]+):",
+  "([^ :]+) : warning",
+  "([^:]+): warning",
+  ".*file: .* has no symbols",
+  "\"[^\"]*\", line [0-9]+: remark\\([0-9]*\\):",
+  "^CMake Warning.*:",
+  0
+};
+
+static const char* buildLogLines[] = {
+  "[ 42%] Building CXX object Source/CMakeFiles/CMakeLib.dir/cmake.cxx.o",
+  "/usr/bin/c++ -DCMAKE_BUILD_WITH_CMAKE -I/src/Source -O2 -g -o "
+  "CMakeFiles/CMakeLib.dir/cmake.cxx.o -c /src/Source/cmake.cxx",
+  "/src/Source/cmake.cxx:123: warning: unused variable 'x'",
+  "/src/Source/cmake.cxx:456: error: 'y' was not declared in this scope",
+  "Linking CXX static library libCMakeLib.a",
+  "ld: warning: directory not found for option '-L/opt/lib'",
+  "make[2]: *** [Source/CMakeFiles/cmake.dir/cmakemain.cxx.o] Error 1",
+  "In file included from /src/Source/cmStandardIncludes.h:12:",
+  0
+};
+
+//----------------------------------------------------------------------------
+static bool testBuildLog()
+{
+  // Lines get long when compilers print full command lines, so repeat
+  // the samples with growing prefixes.
+  kwsys_stl::vector<kwsys_stl::string> lines;
+  for(int i = 0; i < 100; ++i)
+    {
+    kwsys_stl::string prefix(static_cast<size_t>(i), 'x');
+    for(const char** l = buildLogLines; *l; ++l)
+      {
+      lines.push_back(prefix + *l);
+      }
+    }
+
+  bool ok = true;
+  clock_t elapsed[2] = {0, 0};
+  int matches[2] = {0, 0};
+  for(const char** p = buildLogPatterns; *p; ++p)
+    {
+    kwsys::RegularExpression re[2];
+    re[0].compile(*p);
+    re[1].compile(*p);
+    re[1].set_engine(kwsys::RegularExpression::Linear);
+    for(int e = 0; e < 2; ++e)
+      {
+      clock_t start = clock();
+      for(size_t i = 0; i < lines.size(); ++i)
+        {
+        matches[e] += re[e].find(lines[i]) ? 1 : 0;
+        }
+      elapsed[e] += clock() - start;
+      }
+    for(size_t i = 0; i < lines.size(); ++i)
+      {
+      ok = compareEngines(*p, lines[i].c_str()) && ok;
+      }
+    }
+  if(matches[0] != matches[1])
+    {
+    ok = false;
+    }
+  kwsys_ios::cout
+    << "Build log lines matched: " << matches[0] << kwsys_ios::endl
+    << "  backtracking: "
+    << static_cast<double>(elapsed[0]) / CLOCKS_PER_SEC << "s"
+    << kwsys_ios::endl
+    << "  linear: "
+    << static_cast<double>(elapsed[1]) / CLOCKS_PER_SEC << "s"
+    << kwsys_ios::endl;
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+int testRegularExpression(int, char*[])
+{
+  int res = 0;
+  if(!testFixedCases())
+    {
+    res = 1;
+    }
+  if(!testRandomCases())
+    {
+    res = 1;
+    }
+  if(!testPathological())
+    {
+    res = 1;
+    }
+  if(!testBuildLog())
+    {
+    res = 1;
+    }
+  return res;
+}
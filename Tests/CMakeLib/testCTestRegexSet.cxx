@@ -0,0 +1,79 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2014 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "CTest/cmCTestRegexSet.h"
+
+#include "cmStandardIncludes.h"
+
+struct test_literal
+{
+  const char* regex;
+  const char* literal;
+};
+
+static test_literal const literals[] = {
+  {"error: ", "error: "},
+  {"^Error[0-9]+:", "Error"},
+  {"warning|error", ""},
+  {"ab+c", "ab"},
+  {"[]]abc", "abc"},
+  {"[^]]abc", "abc"},
+  {"([])abc(]x)", ""},
+  {"([^])abc(]x)", ""},
+  {"([]x])yz", "yz"},
+  {"([^]x])yz", "yz"},
+  {0,0}
+};
+
+struct test_match
+{
+  const char* regex;
+  const char* line;
+};
+
+static test_match const matches[] = {
+  {"([])abc(]x)", "(x"},
+  {"([^])abc(]x)", "zx"},
+  {"([]x])yz", "]yz"},
+  {"([^]x])yz", "ayz"},
+  {"error: ", "a.c:1: error: bad"},
+  {0,0}
+};
+
+int testCTestRegexSet(int, char*[])
+{
+  int result = 0;
+  for(test_literal const* p = literals; p->regex; ++p)
+    {
+    std::string literal = cmCTestRegexSet::GetRequiredLiteral(p->regex);
+    if(literal != p->literal)
+      {
+      printf("expected literal [%s] for [%s], got [%s]\n",
+             p->literal, p->regex, literal.c_str());
+      result = 1;
+      }
+    }
+
+  // Every line the expression matches must also be found by the set.
+  for(test_match const* m = matches; m->regex; ++m)
+    {
+    cmCTestRegexSet set;
+    set.Add("never matched");
+    int index = set.Add(m->regex);
+    set.Scan(m->line);
+    if(set.Find(0, set.GetSize()) != index)
+      {
+      printf("expected [%s] to match [%s]\n", m->regex, m->line);
+      result = 1;
+      }
+    }
+  return result;
+}
@@ -0,0 +1,8 @@
+int four(int x)
+{
+  if(x > 0)
+    {
+    return x - x;
+    }
+  return 0;
+}
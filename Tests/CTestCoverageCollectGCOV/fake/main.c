@@ -0,0 +1,9 @@
+int one(int);
+int two(int);
+int three(int);
+int four(int);
+
+int main(void)
+{
+  return one(1) + two(2) + three(0) + four(0);
+}
@@ -0,0 +1,23 @@
+# Configure the synthetic project next to this script, run all of its
+# trivial tests in parallel and report the total test time ctest prints.
+#
+# Usage:
+#   cmake -Dgen=<generator> -Ddir=<build-dir> [-Dmake=<make-program>]
+#         [-DTESTS=10000] [-DPARALLEL=8] -P Benchmark.cmake
+include(${CMAKE_CURRENT_LIST_DIR}/../PerformanceBenchmark.cmake)
+if(NOT TESTS)
+  set(TESTS 10000)
+endif()
+if(NOT PARALLEL)
+  set(PARALLEL 8)
+endif()
+
+benchmark_configure(-DTESTS=${TESTS} -DBUILD_TESTING=ON)
+benchmark_run("Running the tests" ${CMAKE_CTEST_COMMAND} -j${PARALLEL})
+
+message("Tests: ${TESTS} run with -j${PARALLEL}")
+if("${out}" MATCHES "Total Test time \\(real\\) = *([0-9.]+) sec")
+  message("Test time: ${CMAKE_MATCH_1}s")
+else()
+  message("ctest did not report the total test time:\n${out}")
+endif()
@@ -0,0 +1,3 @@
+# Print a recorded build log as if a build had produced it.
+file(READ "${LOG}" content)
+message("${content}")
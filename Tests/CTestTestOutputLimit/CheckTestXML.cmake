@@ -0,0 +1,11 @@
+# A measurement printed in the omitted part of the output is still
+# recorded for the test.
+file(READ "${DIR}/Testing/TAG" tag)
+string(REGEX REPLACE "\n.*" "" tag "${tag}")
+file(READ "${DIR}/Testing/${tag}/Test.xml" xml)
+if(NOT xml MATCHES "<NamedMeasurement name=\"middle\" type=\"text/string\"><Value>500</Value>")
+  message(FATAL_ERROR "Measurement \"middle\" not found in Test.xml")
+endif()
+if(xml MATCHES "<DartMeasurement")
+  message(FATAL_ERROR "Measurement tag left in the test output")
+endif()
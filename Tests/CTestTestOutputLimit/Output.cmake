@@ -0,0 +1,11 @@
+message("first line")
+foreach(i RANGE ${LINES})
+  message("middle line ${i}")
+  if(i EQUAL "${MEASURE}")
+    message("<DartMeasurement name=\"middle\" type=\"text/string\">${i}</DartMeasurement>")
+  endif()
+endforeach()
+if(FULL)
+  message("CTEST_FULL_OUTPUT")
+endif()
+message(FATAL_ERROR "last line")
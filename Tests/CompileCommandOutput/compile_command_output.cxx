@@ -1,6 +1,11 @@
 #include "file_with_underscores.h"
 #include "relative.h"
 
+// Fail to compile if the definition lost a character on its way through
+// the build system or the compile commands database.
+typedef char compile_command_string_check[
+  sizeof(COMPILE_COMMAND_STRING) == sizeof("quoted \\ value")? 1 : -1];
+
 int main (int argc, char** argv)
 {
   file_with_underscores();
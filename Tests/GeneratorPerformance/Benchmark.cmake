@@ -0,0 +1,49 @@
+# Configure and generate the synthetic project next to this script and
+# report the generate time and peak memory CMake prints with --debug-output.
+# For the Ninja generator also report the size of build.ninja and how long
+# a dry run of ninja takes to load it.
+#
+# Usage:
+#   cmake -Dgen=<generator> -Ddir=<build-dir> [-Dmake=<make-program>]
+#         [-DSOURCES=100000] [-DTARGETS=1000] -P Benchmark.cmake
+include(${CMAKE_CURRENT_LIST_DIR}/../PerformanceBenchmark.cmake)
+if(NOT SOURCES)
+  set(SOURCES 100000)
+endif()
+if(NOT TARGETS)
+  set(TARGETS 1000)
+endif()
+
+benchmark_configure(--debug-output
+  -DSOURCES=${SOURCES} -DTARGETS=${TARGETS}
+  -DCMAKE_EXPORT_COMPILE_COMMANDS=ON)
+
+message("Generator: ${gen}")
+message("Sources: ${SOURCES} in ${TARGETS} targets")
+foreach(stat "Generate time: [^\n]*" "Peak memory: [^\n]*")
+  if("${out}" MATCHES "(${stat})")
+    message("${CMAKE_MATCH_1}")
+  endif()
+endforeach()
+
+if(gen MATCHES "Ninja")
+  file(READ "${dir}/build.ninja" manifest)
+  string(LENGTH "${manifest}" size)
+  set(manifest)
+  message("build.ninja size: ${size} bytes")
+
+  file(STRINGS "${dir}/CMakeCache.txt" make REGEX "^CMAKE_MAKE_PROGRAM:")
+  string(REGEX REPLACE "^[^=]*=" "" make "${make}")
+  execute_process(
+    COMMAND ${make} -n -d stats
+    WORKING_DIRECTORY "${dir}"
+    OUTPUT_VARIABLE out
+    ERROR_VARIABLE out
+    RESULT_VARIABLE result
+    )
+  if("${out}" MATCHES "(\\.ninja parse[^\n]*)")
+    message("ninja -n: ${CMAKE_MATCH_1}")
+  else()
+    message("ninja -n did not report statistics:\n${out}")
+  endif()
+endif()
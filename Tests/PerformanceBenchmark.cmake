@@ -0,0 +1,37 @@
+# Common code for the Benchmark.cmake scripts of the *Performance tests.
+# The including script must be given -Dgen=<generator> and -Ddir=<build-dir>
+# and may be given -Dmake=<make-program>.
+foreach(arg gen dir)
+  if(NOT DEFINED ${arg})
+    message(FATAL_ERROR "${arg} not given!")
+  endif()
+endforeach()
+
+# Run a command in the build tree and store its output in "out".  Stop
+# with the output if it fails.
+macro(benchmark_run what)
+  execute_process(
+    COMMAND ${ARGN}
+    WORKING_DIRECTORY "${dir}"
+    OUTPUT_VARIABLE out
+    ERROR_VARIABLE out
+    RESULT_VARIABLE result
+    )
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${what} failed:\n${out}")
+  endif()
+endmacro()
+
+# Configure the project in the directory of the including script in a
+# fresh build tree with the given additional options.
+macro(benchmark_configure)
+  set(options)
+  if(make)
+    list(APPEND options "-DCMAKE_MAKE_PROGRAM=${make}")
+  endif()
+  file(REMOVE "${dir}/CMakeCache.txt")
+  file(MAKE_DIRECTORY "${dir}")
+  benchmark_run("Generating the project"
+    ${CMAKE_COMMAND} "${CMAKE_CURRENT_LIST_DIR}" -G "${gen}" ${ARGN}
+    ${options})
+endmacro()
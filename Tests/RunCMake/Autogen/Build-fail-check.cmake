@@ -0,0 +1,3 @@
+if(EXISTS "${RunCMake_TEST_BINARY_DIR}/moc_bad.cpp")
+  set(RunCMake_TEST_FAILED "moc_bad.cpp of the failed job was not removed.\n")
+endif()
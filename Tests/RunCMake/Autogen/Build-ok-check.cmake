@@ -0,0 +1,10 @@
+foreach(h obj1 obj2 obj3 obj4 obj5)
+  set(moc "${RunCMake_TEST_BINARY_DIR}/moc_${h}.cpp")
+  if(NOT EXISTS "${moc}")
+    set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}${moc} was not generated.\n")
+  endif()
+endforeach()
+# The output of moc runs that succeed is not printed.
+if(actual_stdout MATCHES "fakemoc: processed")
+  set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}Output of moc was printed:\n${actual_stdout}\n")
+endif()
@@ -0,0 +1,25 @@
+# Pretend to use Qt 4 with a moc built by this project.
+set(QT_VERSION_MAJOR 4)
+add_executable(fakemoc fakemoc.cpp)
+set_property(TARGET fakemoc PROPERTY
+  RUNTIME_OUTPUT_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR})
+add_executable(Qt4::moc IMPORTED)
+set_property(TARGET Qt4::moc PROPERTY IMPORTED_LOCATION
+  ${CMAKE_CURRENT_BINARY_DIR}/fakemoc${CMAKE_EXECUTABLE_SUFFIX})
+set(CMAKE_AUTOMOC ON)
+
+# Give moc more headers than jobs may run at once.
+set(headers)
+foreach(h obj1 obj2 obj3 obj4 obj5)
+  file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/${h}.h "class ${h}\n{\n  Q_OBJECT\n};\n")
+  list(APPEND headers ${CMAKE_CURRENT_BINARY_DIR}/${h}.h)
+endforeach()
+if(FAIL)
+  file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/bad.h
+    "class bad\n{\n  Q_OBJECT\n  FAKEMOC_FAIL\n};\n")
+  list(APPEND headers ${CMAKE_CURRENT_BINARY_DIR}/bad.h)
+endif()
+
+add_library(mocked STATIC empty.cpp ${headers})
+set_property(TARGET mocked PROPERTY AUTOGEN_PARALLEL 3)
+set_property(TARGET mocked PROPERTY AUTOGEN_TARGET_DEPENDS fakemoc)
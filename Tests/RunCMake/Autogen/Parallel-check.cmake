@@ -0,0 +1,11 @@
+macro(check_parallel target expect)
+  set(info "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/${target}_automoc.dir/AutogenInfo.cmake")
+  file(STRINGS "${info}" line REGEX "AM_PARALLEL")
+  if(NOT line STREQUAL "set(AM_PARALLEL \"${expect}\")")
+    set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}${target} has\n  ${line}\nbut expected AM_PARALLEL \"${expect}\".\n")
+  endif()
+endmacro()
+
+check_parallel(withProperty "3")
+check_parallel(withoutProperty "")
+check_parallel(fromVariable "AUTO")
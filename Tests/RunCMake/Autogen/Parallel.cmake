@@ -0,0 +1,16 @@
+# Pretend to use Qt 4 so that the autogen targets are set up.
+set(QT_VERSION_MAJOR 4)
+add_executable(Qt4::moc IMPORTED)
+set_property(TARGET Qt4::moc PROPERTY
+  IMPORTED_LOCATION ${CMAKE_CURRENT_BINARY_DIR}/moc)
+set(CMAKE_AUTOMOC ON)
+
+add_library(withProperty STATIC empty.cpp)
+set_property(TARGET withProperty PROPERTY AUTOGEN_PARALLEL 3)
+
+# Only the target property is used, never a variable in the directory.
+set(_autogen_parallel 5)
+add_library(withoutProperty STATIC empty.cpp)
+
+set(CMAKE_AUTOGEN_PARALLEL AUTO)
+add_library(fromVariable STATIC empty.cpp)
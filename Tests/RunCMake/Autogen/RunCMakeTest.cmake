@@ -0,0 +1,20 @@
+include(RunCMake)
+
+run_cmake(Parallel)
+
+# Run moc jobs in parallel with a stand-in moc.  Its location is known
+# only for generators without a configuration subdirectory.
+if(NOT RunCMake_GENERATOR MATCHES "Visual Studio|Xcode")
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Build-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  run_cmake(Build)
+  run_cmake_command(Build-ok ${CMAKE_COMMAND} --build .)
+  run_cmake_command(Build-reconfigure ${CMAKE_COMMAND} -DFAIL=ON .)
+  # Run the autogen step directly for a result independent of the tool.
+  run_cmake_command(Build-fail ${CMAKE_COMMAND} -E cmake_autogen
+    ${RunCMake_TEST_BINARY_DIR}/CMakeFiles/mocked_automoc.dir/ Debug)
+  unset(RunCMake_TEST_NO_CLEAN)
+  unset(RunCMake_TEST_BINARY_DIR)
+endif()
@@ -0,0 +1,33 @@
+// Stand-in for moc: write a small source for the header given last on
+// the command line to the file given with -o.  Fail for headers that
+// contain FAKEMOC_FAIL.
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[])
+{
+  std::string out;
+  for(int i = 1; i + 1 < argc; ++i)
+    {
+    if(std::string(argv[i]) == "-o")
+      {
+      out = argv[i+1];
+      }
+    }
+  std::string in = argv[argc-1];
+  std::ifstream fin(in.c_str());
+  std::string line;
+  while(std::getline(fin, line))
+    {
+    if(line.find("FAKEMOC_FAIL") != line.npos)
+      {
+      std::cout << "fakemoc: cannot process " << in << std::endl;
+      return 1;
+      }
+    }
+  std::ofstream fout(out.c_str());
+  fout << "// fakemoc output for " << in << "\n";
+  std::cout << "fakemoc: processed " << in << std::endl;
+  return fout? 0 : 1;
+}
@@ -0,0 +1,38 @@
+set(f "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestCostData.txt")
+if(NOT EXISTS "${f}")
+  set(RunCMake_TEST_FAILED "Cost data file not found:\n  ${f}")
+  return()
+endif()
+file(STRINGS "${f}" lines)
+
+# Each test run once more updates its entry to the format with variance.
+# The test runs take well under a second, which bounds the new average
+# and variance.
+macro(check_entry name runs min_cost max_cost min_var max_var)
+  set(entry)
+  foreach(line IN LISTS lines)
+    if(line MATCHES "^${name} ")
+      set(entry "${line}")
+    endif()
+  endforeach()
+  if(NOT entry MATCHES "^${name} ([0-9]+) ([0-9.e+-]+) ([0-9.e+-]+)$")
+    set(RunCMake_TEST_FAILED "Entry for ${name} is \"${entry}\" in:\n  ${f}")
+    return()
+  endif()
+  if(NOT CMAKE_MATCH_1 EQUAL ${runs} OR
+      CMAKE_MATCH_2 LESS ${min_cost} OR CMAKE_MATCH_2 GREATER ${max_cost} OR
+      CMAKE_MATCH_3 LESS ${min_var} OR CMAKE_MATCH_3 GREATER ${max_var})
+    set(RunCMake_TEST_FAILED "Entry for ${name} is out of range:\n  ${entry}")
+    return()
+  endif()
+endmacro()
+check_entry(Short 6 0.8 1 0 0.2)
+check_entry(Long 6 8.3 8.5 11 14)
+check_entry(Unsteady 6 5 5.2 20.9 25.9)
+check_entry(Head 4 1.5 1.75 0.18 0.75)
+check_entry(Tail 4 5.25 5.5 9 9.2)
+
+list(FIND lines "Gone 2 3 1" gone)
+if(gone EQUAL -1)
+  set(RunCMake_TEST_FAILED "Entry for Gone was not kept in:\n  ${f}")
+endif()
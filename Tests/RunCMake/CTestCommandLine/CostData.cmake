@@ -0,0 +1,19 @@
+enable_testing()
+foreach(t Short Long Unsteady Head Tail)
+  add_test(NAME ${t} COMMAND ${CMAKE_COMMAND} -E echo ${t})
+endforeach()
+set_tests_properties(Tail PROPERTIES DEPENDS Head)
+
+# Seed the costs of previous runs.  Unsteady is scheduled by its average
+# plus one standard deviation, 11, and Head by the cost of the chain
+# through Tail, 9.  Head and Tail use the older format without variance.
+# Gone is not a test of this project and must be kept as is.
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/Testing/Temporary/CTestCostData.txt"
+  "Short 5 1 0\n"
+  "Long 5 10 0\n"
+  "Unsteady 5 6 25\n"
+  "Head 3 2\n"
+  "Tail 3 7\n"
+  "Gone 2 3 1\n"
+  "---\n"
+  )
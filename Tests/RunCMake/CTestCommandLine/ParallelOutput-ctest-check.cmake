@@ -0,0 +1,17 @@
+set(log "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/LastTest.log")
+if(EXISTS "${log}")
+  file(READ "${log}" log_content)
+else()
+  set(RunCMake_TEST_FAILED "Log file not found:\n  ${log}")
+  return()
+endif()
+foreach(t RANGE 1 16)
+  foreach(line "line 1 " "line 50 " "line 51 " "line 100 " "done")
+    string(FIND "${log_content}" "test ${t} ${line}" pos)
+    if(pos EQUAL -1)
+      set(RunCMake_TEST_FAILED
+        "Output \"test ${t} ${line}\" missing from:\n  ${log}")
+      return()
+    endif()
+  endforeach()
+endforeach()
@@ -0,0 +1,7 @@
+foreach(i RANGE 1 100)
+  message("test ${t} line ${i} ........................................")
+  if(i EQUAL 50 AND t MATCHES "[48]$")
+    execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  endif()
+endforeach()
+message("test ${t} done")
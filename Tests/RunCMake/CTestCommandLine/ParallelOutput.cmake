@@ -0,0 +1,5 @@
+enable_testing()
+foreach(t RANGE 1 16)
+  add_test(NAME Output${t} COMMAND ${CMAKE_COMMAND} -Dt=${t}
+    -P ${CMAKE_CURRENT_SOURCE_DIR}/ParallelOutput-print.cmake)
+endforeach()
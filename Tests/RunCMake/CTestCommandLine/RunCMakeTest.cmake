@@ -0,0 +1,18 @@
+include(RunCMake)
+
+function(run_ctest_case case)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/${case}-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  run_cmake(${case})
+  run_cmake_command(${case}-ctest ${CMAKE_CTEST_COMMAND} ${ARGN})
+endfunction()
+
+# Many tests printing more output than fits in one read, some of them
+# pausing half way, must all have their complete output recorded.
+run_ctest_case(ParallelOutput -j8)
+
+# Tests heading the longest chains by recorded cost start first, and the
+# cost data file is rewritten with updated entries.
+run_ctest_case(CostData -j8)
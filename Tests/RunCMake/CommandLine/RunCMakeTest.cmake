@@ -43,3 +43,6 @@ run_cmake_command(E_sleep-bad-arg2 ${CMAKE_COMMAND} -E sleep 1 -1)
 run_cmake_command(E_sleep-one-tenth ${CMAKE_COMMAND} -E sleep 0.1)
 
 run_cmake_command(P_directory ${CMAKE_COMMAND} -P ${RunCMake_SOURCE_DIR})
+
+run_cmake_command(profile ${CMAKE_COMMAND} --profile=profile.json
+  -P ${RunCMake_SOURCE_DIR}/profile.cmake)
@@ -0,0 +1,4 @@
+file(READ ${RunCMake_TEST_BINARY_DIR}/profile.json profile)
+if(NOT profile MATCHES "\"traceEvents\": \\[.*\"name\": \"profile_macro\", \"cat\": \"macro\", \"ph\": \"X\".*\"stackFrames\": {.*\"name\": \"profile_macro [^\"]*/profile.cmake:2\", \"parent\": \"[0-9]+\"")
+  set(RunCMake_TEST_FAILED "Unexpected profile content:\n${profile}")
+endif()
@@ -0,0 +1,7 @@
+function(profile_function)
+  profile_macro()
+endfunction()
+macro(profile_macro)
+  set(x 1)
+endmacro()
+profile_function()
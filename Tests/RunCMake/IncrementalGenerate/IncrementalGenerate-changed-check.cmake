@@ -0,0 +1,3 @@
+# The target of b depends on the target of a, so both are generated.
+set(kept c)
+include(${RunCMake_SOURCE_DIR}/check.cmake)
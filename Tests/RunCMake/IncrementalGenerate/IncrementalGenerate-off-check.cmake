@@ -0,0 +1,2 @@
+set(kept)
+include(${RunCMake_SOURCE_DIR}/check.cmake)
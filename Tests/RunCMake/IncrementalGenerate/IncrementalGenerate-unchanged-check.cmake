@@ -0,0 +1,2 @@
+set(kept a b c)
+include(${RunCMake_SOURCE_DIR}/check.cmake)
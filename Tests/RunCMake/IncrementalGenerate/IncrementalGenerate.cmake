@@ -0,0 +1,3 @@
+add_subdirectory(a)
+add_subdirectory(b)
+add_subdirectory(c)
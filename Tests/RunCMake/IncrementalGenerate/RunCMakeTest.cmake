@@ -0,0 +1,31 @@
+include(RunCMake)
+
+# Use a single build tree and mark the files generated for each directory
+# to see which are written again.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/IncrementalGenerate-build)
+set(RunCMake_TEST_NO_CLEAN 1)
+file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+
+macro(mark_build_files)
+  foreach(d a b c)
+    file(APPEND
+      "${RunCMake_TEST_BINARY_DIR}/${d}/CMakeFiles/tgt_${d}.dir/build.make"
+      "# marker\n")
+  endforeach()
+endmacro()
+
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/a_value.txt" "1")
+set(RunCMake_TEST_OPTIONS -DCMAKE_INCREMENTAL_GENERATE=ON)
+run_cmake(IncrementalGenerate)
+unset(RunCMake_TEST_OPTIONS)
+# The first run sets some variables only when the cache is created.
+run_cmake_command(IncrementalGenerate-rerun ${CMAKE_COMMAND} .)
+mark_build_files()
+run_cmake_command(IncrementalGenerate-unchanged ${CMAKE_COMMAND} .)
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/a_value.txt" "2")
+run_cmake_command(IncrementalGenerate-changed ${CMAKE_COMMAND} .)
+run_cmake_command(IncrementalGenerate-build ${CMAKE_COMMAND} --build .)
+mark_build_files()
+run_cmake_command(IncrementalGenerate-off
+  ${CMAKE_COMMAND} -DCMAKE_INCREMENTAL_GENERATE=OFF .)
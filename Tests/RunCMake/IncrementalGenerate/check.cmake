@@ -0,0 +1,15 @@
+foreach(d a b c)
+  file(READ
+    "${RunCMake_TEST_BINARY_DIR}/${d}/CMakeFiles/tgt_${d}.dir/build.make"
+    content)
+  list(FIND kept ${d} i)
+  if(content MATCHES "# marker")
+    if(i EQUAL -1)
+      set(RunCMake_TEST_FAILED
+        "${RunCMake_TEST_FAILED}Build files of ${d} were not generated.\n")
+    endif()
+  elseif(NOT i EQUAL -1)
+    set(RunCMake_TEST_FAILED
+      "${RunCMake_TEST_FAILED}Build files of ${d} were generated again.\n")
+  endif()
+endforeach()
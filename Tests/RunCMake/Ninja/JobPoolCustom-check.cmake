@@ -0,0 +1,23 @@
+set(f "${RunCMake_TEST_BINARY_DIR}/build.ninja")
+if(NOT EXISTS "${f}")
+  set(RunCMake_TEST_FAILED "build.ninja not found:\n  ${f}")
+  return()
+endif()
+file(READ "${f}" build_ninja)
+
+# The custom command runs in the pool of the target using it, and the
+# command of each utility target in its own pool.
+foreach(statement
+    "out.txt: CUSTOM_COMMAND|custom_pool"
+    "CMakeFiles/gen: CUSTOM_COMMAND|custom_pool"
+    "CMakeFiles/gen_default: CUSTOM_COMMAND|default_pool"
+    )
+  string(REPLACE "|" ";" statement "${statement}")
+  list(GET statement 0 build)
+  list(GET statement 1 pool)
+  if(NOT build_ninja MATCHES "\nbuild ${build}[^\n]*\n(  [^\n]*\n)*  pool = ${pool}\n")
+    set(RunCMake_TEST_FAILED
+      "build ${build} is not in pool ${pool} in:\n  ${f}")
+    return()
+  endif()
+endforeach()
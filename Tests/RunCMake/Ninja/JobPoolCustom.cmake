@@ -0,0 +1,8 @@
+set_property(GLOBAL PROPERTY JOB_POOLS custom_pool=1 default_pool=2)
+
+add_custom_command(OUTPUT out.txt COMMAND ${CMAKE_COMMAND} -E touch out.txt)
+add_custom_target(gen ALL DEPENDS out.txt COMMAND ${CMAKE_COMMAND} -E echo gen)
+set_property(TARGET gen PROPERTY JOB_POOL_CUSTOM custom_pool)
+
+set(CMAKE_JOB_POOL_CUSTOM default_pool)
+add_custom_target(gen_default ALL COMMAND ${CMAKE_COMMAND} -E echo default)
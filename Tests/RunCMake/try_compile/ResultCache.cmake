@@ -0,0 +1,58 @@
+enable_language(C)
+set(CMAKE_TRY_COMPILE_CACHE_DIR ${CMAKE_CURRENT_BINARY_DIR}/ResultCache)
+file(REMOVE_RECURSE ${CMAKE_TRY_COMPILE_CACHE_DIR})
+
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/src.c)
+if(NOT RESULT)
+  message(FATAL_ERROR "try_compile failed")
+endif()
+file(GLOB entries ${CMAKE_TRY_COMPILE_CACHE_DIR}/*)
+list(LENGTH entries count)
+if(NOT count EQUAL 1)
+  message(FATAL_ERROR "Expected one cache entry but got:\n ${entries}")
+endif()
+
+# The same check is answered from the cache entry.
+file(WRITE ${entries} "1\nfrom cache\n")
+unset(RESULT CACHE)
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out)
+if(RESULT OR NOT out STREQUAL "from cache\n")
+  message(FATAL_ERROR "Cache entry not used: ${RESULT}\n${out}")
+endif()
+
+# A different check gets its own entry.
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  COMPILE_DEFINITIONS -DRESULT_CACHE)
+if(NOT RESULT)
+  message(FATAL_ERROR "try_compile with definitions failed")
+endif()
+file(GLOB entries ${CMAKE_TRY_COMPILE_CACHE_DIR}/*)
+list(LENGTH entries count)
+if(NOT count EQUAL 2)
+  message(FATAL_ERROR "Expected two cache entries but got:\n ${entries}")
+endif()
+
+# A corrupt cache entry is treated as a miss and replaced.
+file(GLOB entries ${CMAKE_TRY_COMPILE_CACHE_DIR}/*)
+foreach(entry ${entries})
+  file(WRITE ${entry} "")
+endforeach()
+unset(RESULT CACHE)
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out)
+if(NOT RESULT OR out STREQUAL "")
+  message(FATAL_ERROR "Corrupt cache entry used: ${RESULT}\n${out}")
+endif()
+
+# Editing the rules override file gives a new entry.
+set(CMAKE_USER_MAKE_RULES_OVERRIDE ${CMAKE_CURRENT_BINARY_DIR}/Override.cmake)
+file(WRITE ${CMAKE_USER_MAKE_RULES_OVERRIDE} "# first\n")
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/src.c)
+file(WRITE ${CMAKE_USER_MAKE_RULES_OVERRIDE} "# second\n")
+try_compile(RESULT ${CMAKE_CURRENT_BINARY_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/src.c)
+file(GLOB entries ${CMAKE_TRY_COMPILE_CACHE_DIR}/*)
+list(LENGTH entries count)
+if(NOT count EQUAL 4)
+  message(FATAL_ERROR "Expected four cache entries but got:\n ${entries}")
+endif()